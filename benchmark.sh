@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# Detener el script si ocurre algún error
+set -e
+
+# Colores para que se vea bonito en la terminal
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+RED='\033[0;31m'
+NC='\033[0m' # No Color
+
+# Parámetros (se pueden sobreescribir desde el entorno)
+MAX_SLOWDOWN="${MAX_SLOWDOWN:-1.25}"        # 1.25 = falla si algo va un 25 % más lento
+BASELINE="${BASELINE:-bench_baseline.yml}"  # Relativo a build/
+CLIPS_DIR="${CLIPS_DIR:-../clips}"          # Clips cortos opcionales (.mp4/.avi)
+
+echo -e "${GREEN}=== SUITE DE RENDIMIENTO (bench_pipeline) ===${NC}"
+echo ""
+
+# 1. Configurar directorio de compilación
+echo -e "${YELLOW}🔨 Configurando entorno de compilación (CMake)...${NC}"
+
+if [ ! -d "build" ]; then
+    mkdir build
+fi
+
+cd build
+
+# Release: medir con optimizaciones, igual que en producción
+cmake .. -DCMAKE_BUILD_TYPE=Release
+
+# 2. Compilar el ejecutable 'bench_pipeline'
+echo -e "${YELLOW}⚙️  Compilando 'bench_pipeline'...${NC}"
+make bench_pipeline -j$(nproc)
+
+# 3. Ejecutar: la primera vez se guarda la línea base, después se compara contra ella
+ARGS=(--baseline "$BASELINE" --max-slowdown "$MAX_SLOWDOWN")
+if [ -d "$CLIPS_DIR" ]; then
+    ARGS+=(--clips "$CLIPS_DIR")
+fi
+
+echo ""
+echo "-----------------------------------------------------"
+if [ ! -f "$BASELINE" ] || [ "$1" == "--save-baseline" ]; then
+    echo -e "${YELLOW}💾 Generando línea base en build/$BASELINE${NC}"
+    ./bench_pipeline "${ARGS[@]}" --save-baseline
+else
+    set +e
+    ./bench_pipeline "${ARGS[@]}"
+    STATUS=$?
+    set -e
+    echo "-----------------------------------------------------"
+    if [ $STATUS -eq 1 ]; then
+        echo -e "${RED}❌ Regresión de rendimiento (umbral ${MAX_SLOWDOWN}x).${NC}"
+        echo "   Si el cambio es intencional: ./benchmark.sh --save-baseline"
+        exit 1
+    elif [ $STATUS -ne 0 ]; then
+        echo -e "${RED}❌ La suite falló (código $STATUS).${NC}"
+        exit $STATUS
+    fi
+fi
+
+echo -e "${GREEN}✅ Proceso finalizado.${NC}"
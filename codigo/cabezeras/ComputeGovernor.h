@@ -0,0 +1,55 @@
+#ifndef COMPUTE_GOVERNOR_H
+#define COMPUTE_GOVERNOR_H
+
+#include <string>
+#include <vector>
+
+// Perillas de calidad/costo del pipeline que el gobernador ajusta en caliente
+struct DetectionKnobs {
+    double hogScale;   // Paso entre escalas de detectMultiScale
+    int winStride;     // Stride de la ventana HOG (múltiplo de 8)
+    int detectEvery;   // HOG solo 1 de cada N frames
+    int featureEvery;  // Puntos clave solo 1 de cada N frames
+    double downscale;  // Factor de reducción antes de HOG (1.0 = tamaño original)
+};
+
+// Tiempos medidos de cada etapa de un frame (ms)
+struct StageTimings {
+    double lightingMs;
+    double featuresMs;
+    double detectionMs;
+    double totalMs;
+};
+
+class ComputeGovernor {
+private:
+    std::vector<DetectionKnobs> levels; // Nivel 0 = calidad máxima
+    int currentLevel;
+
+    double targetFPS; // 0 = sin objetivo de FPS
+    double cpuCap;    // 0 = sin límite de CPU
+
+    double avgFrameMs;     // Media móvil exponencial del tiempo por frame
+    int overBudgetFrames;  // Frames seguidos por encima del presupuesto
+    int headroomFrames;    // Frames seguidos con margen de sobra
+    int cooldown;          // Frames a esperar tras un cambio antes de decidir otra vez
+    double lastCpu;        // Última muestra de CPU recibida (%)
+    int cpuOverSamples;    // Muestras de CPU seguidas sobre el tope (no frames)
+
+    void changeLevel(int newLevel, const std::string& reason, const StageTimings& t);
+
+public:
+    // Constructor: _targetFPS y _cpuCap en 0 desactivan cada restricción
+    ComputeGovernor(double _targetFPS = 15.0, double _cpuCap = 75.0);
+
+    // Reporta las mediciones del último frame. cpuUsage < 0 = no hay muestra de CPU nueva
+    // en este frame (se conserva la anterior). Devuelve true si cambió el nivel.
+    bool update(const StageTimings& timings, double cpuUsage);
+
+    const DetectionKnobs& knobs() const { return levels[currentLevel]; }
+    int getLevel() const { return currentLevel; }
+    int getNumLevels() const { return (int)levels.size(); }
+    double getAvgFrameMs() const { return avgFrameMs; }
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef DETECTION_FILTERS_H
+#define DETECTION_FILTERS_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "DetectionZones.h"
+
+// --- FILTRO DE DETECCIONES ---
+// Umbrales de la zona en la que cae la caja (por defecto, los globales de siempre)
+bool isValidDetection(cv::Rect r, double weight, int frameWidth, int frameHeight, const ZoneFilter& f = ZoneFilter());
+
+// Intersección sobre unión de dos cajas (0 si no se tocan)
+float computeIoU(const cv::Rect& a, const cv::Rect& b);
+
+// --- SUPRESIÓN NO MÁXIMA MEJORADA ---
+std::vector<cv::Rect> improvedNMS(std::vector<cv::Rect>& boxes, std::vector<double>& weights, float overlapThresh = 0.3);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef DETECTION_SPOOL_H
+#define DETECTION_SPOOL_H
+
+#include "PoseClient.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Cola persistente en disco de recortes pendientes de enviar a la API.
+// El detector solo escribe en disco; un hilo aparte vacía la cola con reintentos.
+//
+// Formato: segmentos append-only spool_<seq>.seg con registros
+//   [magic | longitud jpeg | timestamp | confianza | caja | crc32] + jpeg
+// y un archivo spool_<seq>.ack con el offset ya confirmado por la API. El hilo de envío lee
+// también el segmento activo (hasta los bytes ya escritos); solo se sella al llegar a segmentBytes.
+// Un registro truncado o con CRC inválido (caída a mitad de escritura) marca el fin del segmento.
+class DetectionSpool {
+private:
+    std::string dir;
+    size_t maxBytes;     // Tope de disco para todos los segmentos
+    size_t segmentBytes; // Tamaño a partir del cual se sella el segmento activo
+    size_t batchSize;    // Registros por petición a la API
+    long long captureSpanMs; // Una petición solo agrupa recortes de una misma captura
+    PoseClient client;
+
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::map<unsigned long long, size_t> segments; // seq -> bytes (incluye el activo)
+    size_t totalBytes;
+    FILE* active;
+    unsigned long long activeSeq;
+    size_t activeAcked;              // Offset del activo ya confirmado por la API
+    unsigned long long uploadingSeq; // Segmento que el hilo está leyendo (no se desaloja)
+    long long evictedRecords;
+
+    std::thread uploader;
+    std::atomic<bool> running;
+
+    std::string segmentPath(unsigned long long seq) const;
+    std::string ackPath(unsigned long long seq) const;
+    void recover();
+    bool openActive();
+    void sealActive();
+    bool evictOldest();
+    size_t readAck(unsigned long long seq) const;
+    void writeAck(unsigned long long seq, size_t offset) const;
+    void removeSegment(unsigned long long seq);
+    // Registros desde offset recorriendo solo las cabeceras (sin leer ni validar los JPEG)
+    size_t countRecords(unsigned long long seq, size_t offset) const;
+    // Lee hasta max registros válidos entre offset y limit (bytes ya sincronizados del segmento);
+    // devuelve el offset tras el último leído.
+    // maxSpanMs >= 0 corta en el primer registro cuya marca de tiempo se aleja más de la del primero.
+    size_t readRecords(unsigned long long seq, size_t offset, size_t limit, size_t max,
+                       std::vector<PoseCrop>& out, long long maxSpanMs = -1) const;
+    void uploadLoop();
+
+public:
+    // Constructor: maxBytes acota el disco usado; al llenarse se desalojan los segmentos más viejos.
+    // captureSpanMs: ventana del PoseBatcher; recortes más separados van en peticiones distintas
+    // para que cada captura conserve su propia alerta al vaciar un atraso.
+    DetectionSpool(std::string _dir, PoseClient _client, size_t _maxBytes = 256u << 20,
+                   size_t _segmentBytes = 4u << 20, size_t _batchSize = 8, int _captureSpanMs = 0);
+    ~DetectionSpool();
+
+    // Recupera segmentos de una ejecución anterior y arranca el hilo de envío
+    void start();
+    void stop();
+
+    // Codifica y persiste (fsync) los recortes. No toca la red.
+    bool append(const std::vector<PoseCrop>& crops);
+
+    size_t pendingBytes();
+    long long getEvictedRecords();
+};
+
+#endif
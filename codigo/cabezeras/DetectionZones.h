@@ -0,0 +1,74 @@
+#ifndef DETECTION_ZONES_H
+#define DETECTION_ZONES_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// Umbrales del filtro de detecciones. Tamaños como fracción del frame para que la
+// configuración valga a cualquier resolución (los valores por defecto son los globales de siempre)
+struct ZoneFilter {
+    double hitThreshold = 0.0;   // Umbral del SVM dentro de HOG
+    double minConfidence = 0.8;  // Peso mínimo tras agrupar
+    double minWidth = 0.08, maxWidth = 0.7;
+    double minHeight = 0.15, maxHeight = 0.9;
+    double minAspect = 1.2, maxAspect = 4.0;
+    double minArea = 0.02;
+};
+
+struct DetectionZone {
+    std::string name;
+    std::vector<cv::Point2f> polygon; // Vértices normalizados [0,1]
+    ZoneFilter filter;
+};
+
+// Trabajo de HOG en la última llamada a detect() frente al barrido del frame completo
+struct ZoneScanStats {
+    long long pixels = 0, windows = 0;
+    long long fullPixels = 0, fullWindows = 0;
+};
+
+// Zonas poligonales de interés de una cámara. Una detección pertenece a la primera zona
+// que contiene el centro de su caja. HOG solo calcula dentro del rectángulo envolvente
+// de cada zona y solo en las escalas cuya ventana cabe en el rango de alturas de la zona.
+// Sin archivo de zonas se usa detectMultiScale tal cual (mismo resultado y costo de siempre).
+//
+// Formato (YAML de FileStorage):
+//   zones:
+//     - name: pasillo
+//       polygon: [ 0.0, 0.35, 1.0, 0.35, 1.0, 1.0, 0.0, 1.0 ]   # x0, y0, x1, y1, ...
+//       minHeight: 0.3
+//       maxHeight: 0.9
+//       minConfidence: 1.0
+// Las claves de ZoneFilter que falten toman su valor por defecto.
+class ZoneSet {
+private:
+    std::vector<DetectionZone> zones;
+    bool configured; // false = solo la zona de frame completo por defecto
+    ZoneScanStats stats;
+
+    std::vector<cv::Point> toPixels(const DetectionZone& z, cv::Size size) const;
+
+public:
+    ZoneSet(); // Una sola zona: el frame completo con los umbrales por defecto
+
+    // false si el archivo no existe o no es válido (se mantiene la zona de frame completo)
+    bool load(const std::string& path);
+
+    // Pirámide por zonas con el detector lineal de hog; found/weights en coordenadas de img
+    // y zoneOf[i] = zona a la que pertenece found[i]
+    void detect(const cv::Mat& img, const cv::HOGDescriptor& hog, cv::Size winStride, double scale0,
+                std::vector<cv::Rect>& found, std::vector<double>& weights, std::vector<int>& zoneOf);
+
+    // Índice de la zona que contiene p (imagen de tamaño size), -1 si ninguna
+    int zoneAt(cv::Point2f p, cv::Size size) const;
+
+    void draw(cv::Mat& frame) const;
+
+    const DetectionZone& zone(int i) const { return zones[i]; }
+    size_t size() const { return zones.size(); }
+    bool isConfigured() const { return configured; }
+    const ZoneScanStats& getStats() const { return stats; }
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef FEATURE_TRACKER_H
+#define FEATURE_TRACKER_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+// OFF: sin puntos clave | ORB: FAST+ORB con emparejamiento | KLT: flujo óptico disperso
+enum class FeatureMode { OFF, ORB, KLT };
+
+class FeatureTracker {
+private:
+    FeatureMode mode;
+    int maxPoints;
+    cv::Ptr<cv::ORB> orb;
+
+    cv::Mat prevGray;
+    std::vector<cv::Point2f> points;
+    std::vector<cv::KeyPoint> prevKeypoints; // Solo modo ORB
+    cv::Mat prevDescriptors;                 // Solo modo ORB
+
+    cv::Point2f globalMotion; // Traslación de cámara estimada (px/frame)
+    double movingFraction;    // Puntos que no siguen el movimiento global
+    double lostFraction;      // Puntos que KLT no pudo seguir
+    bool motionValid;
+    int staticFrames;         // Frames seguidos con escena estática
+    int framesSinceReference; // Frames entre el frame de referencia (prevGray / prevDescriptors) y el actual
+
+    void trackKLT(const cv::Mat& gray, bool redetect);
+    void trackORB(const cv::Mat& gray, bool redetect);
+    // Rellena con FAST solo las celdas de la rejilla que se quedaron sin puntos
+    void redetectLostRegions(const cv::Mat& gray);
+    void estimateMotion(const std::vector<cv::Point2f>& from, const std::vector<cv::Point2f>& to);
+
+public:
+    // Constructor: maxPoints acota el costo de seguimiento por frame
+    FeatureTracker(FeatureMode _mode = FeatureMode::KLT, int _maxPoints = 100);
+
+    // Procesa un frame en gris. redetect=true permite buscar puntos nuevos en este frame.
+    void process(const cv::Mat& gray, bool redetect);
+
+    void setMode(FeatureMode _mode);
+    FeatureMode getMode() const { return mode; }
+
+    const std::vector<cv::Point2f>& getPoints() const { return points; }
+    cv::Point2f getGlobalMotion() const { return globalMotion; }
+
+    // true si la cámara y la escena llevan varios frames sin moverse
+    bool isStatic() const;
+};
+
+#endif
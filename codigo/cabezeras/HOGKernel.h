@@ -0,0 +1,585 @@
+#ifndef HOG_KERNEL_H
+#define HOG_KERNEL_H
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ================= GEOMETRÍA (constexpr) =================
+// Todos los tamaños se conocen en compilación: los bucles internos se desenrollan y
+// los buffers por bloque viven en la pila.
+template<int WinW, int WinH, int BlockSz = 16, int Stride = 8, int CellSz = 8, int NBins = 9>
+struct HOGGeometry {
+    static constexpr int winW = WinW;
+    static constexpr int winH = WinH;
+    static constexpr int blockSize = BlockSz;
+    static constexpr int blockStride = Stride;
+    static constexpr int cellSize = CellSz;
+    static constexpr int nbins = NBins;
+
+    static constexpr int cellsPerSide = BlockSz / CellSz;
+    static constexpr int blockHistSize = NBins * cellsPerSide * cellsPerSide;
+    static constexpr int blocksX = (WinW - BlockSz) / Stride + 1;
+    static constexpr int blocksY = (WinH - BlockSz) / Stride + 1;
+    static constexpr int descriptorSize = blocksX * blocksY * blockHistSize;
+
+    static_assert(BlockSz % CellSz == 0, "El bloque debe contener celdas completas");
+    static_assert((WinW - BlockSz) % Stride == 0 && (WinH - BlockSz) % Stride == 0,
+                  "La ventana debe recorrerse con bloques completos");
+};
+
+// Geometrías de nuestros modelos
+using HOGGeom64x128 = HOGGeometry<64, 128>; // detect_poses_hog / detector por defecto (3780)
+using HOGGeom64x64  = HOGGeometry<64, 64>;  // train_acf (1764)
+
+// Detector lineal: el .txt de Python (un valor por línea) o el .yml de train_acf (clave "detector")
+std::vector<float> loadHOGDetector(const std::string& path);
+
+// Ventana de nuestras geometrías a partir de la dimensión del detector (pesos + bias);
+// Size() si no corresponde a ninguna
+cv::Size hogWinSizeFor(size_t detectorSize);
+
+// ================= SVM CUANTIZADO =================
+// Pesos int8 simétricos con una escala por modelo; el descriptor (L2-Hys, valores en [0,1])
+// se guarda como uint8 con escala fija 1/255. score = bias + sum(d_q * w_q) * scale / 255
+struct QuantizedSVM {
+    std::vector<schar> weights; // Orden del descriptor
+    float scale;                // peso real ~= weights[i] * scale
+    float bias;
+    // Huella del detector float del que salió (tamaño, bias, hash de los pesos): un _q8.yml
+    // de un entrenamiento anterior no debe reemplazar al modelo actual
+    int sourceSize;
+    float sourceBias;
+    uint32_t sourceHash;
+};
+
+inline uchar quantizeFeature(float v) { return cv::saturate_cast<uchar>(v * 255.f); }
+
+// Cuantiza un detector float (formato setSVMDetector: pesos + bias)
+QuantizedSVM quantizeSVM(const std::vector<float>& detector);
+
+// FNV-1a sobre los bytes de los pesos float
+uint32_t detectorHash(const std::vector<float>& detector);
+
+// true si q se cuantizó a partir de exactamente este detector
+bool quantizedFrom(const QuantizedSVM& q, const std::vector<float>& detector);
+
+// Puntuación de referencia (escalar) de un descriptor completo con el modelo cuantizado
+double quantizedScore(const QuantizedSVM& q, const std::vector<float>& descriptor);
+
+bool saveQuantizedSVM(const std::string& path, const QuantizedSVM& q, cv::Size winSize);
+bool loadQuantizedSVM(const std::string& path, QuantizedSVM& q, cv::Size& winSize);
+
+// ================= INTERFAZ =================
+// La especialización concreta se elige al cargar el modelo (createHOGScorer)
+class HOGScorer {
+public:
+    virtual ~HOGScorer() {}
+
+    virtual cv::Size winSize() const = 0;
+    virtual int descriptorSize() const = 0;
+
+    // Descriptor de una ventana (img del tamaño exacto de la ventana), mismo orden que HOGDescriptor
+    virtual void compute(const cv::Mat& img, std::vector<float>& descriptor) const = 0;
+
+    // Una escala: cada bloque se calcula y normaliza una sola vez y su producto con el SVM
+    // se reparte entre todas las ventanas que lo contienen (sin materializar descriptores)
+    virtual void detect(const cv::Mat& img, std::vector<cv::Point>& hits, std::vector<double>& weights,
+                        double hitThreshold, int winStride) const = 0;
+
+    // Pirámide + agrupación de rectángulos, como HOGDescriptor::detectMultiScale: cada nivel se
+    // rellena padding px (REFLECT_101) por lado y los niveles se reparten con cv::parallel_for_
+    virtual void detectMultiScale(const cv::Mat& img, std::vector<cv::Rect>& found, std::vector<double>& weights,
+                                  double hitThreshold = 0, int winStride = 8, double scale0 = 1.05,
+                                  int groupThreshold = 2, int padding = 0) const = 0;
+
+    // A partir de aquí detect() puntúa con enteros (uint8 x int8) en lugar de float32
+    virtual bool setQuantized(const QuantizedSVM& q) = 0;
+    virtual bool isQuantized() const = 0;
+};
+
+// Devuelve nullptr si no hay especialización para winSize o el detector no coincide en tamaño.
+// detector: pesos del SVM lineal + bias al final (formato setSVMDetector); vacío = solo compute().
+std::unique_ptr<HOGScorer> createHOGScorer(cv::Size winSize, const std::vector<float>& detector = std::vector<float>(),
+                                           bool gammaCorrection = false);
+
+// Agrupa detecciones solapadas (promedio de cajas, peso máximo), como HOGDescriptor::groupRectangles
+void groupHOGRectangles(std::vector<cv::Rect>& rects, std::vector<double>& weights, int groupThreshold, double eps = 0.2);
+
+// ================= KERNEL ESPECIALIZADO =================
+template<class G>
+class HOGKernel : public HOGScorer {
+private:
+    // Contribución precalculada de un píxel del bloque a 1, 2 o 4 celdas
+    struct PixEntry {
+        int dx, dy;
+        int count;
+        int histOfs[4];
+        float weight[4]; // peso gaussiano * peso bilineal
+    };
+
+    // Bloque cuantizado rellenado a múltiplo de 16 para cargas SIMD completas
+    static constexpr int qBlockSize = (G::blockHistSize + 15) / 16 * 16;
+
+    std::array<PixEntry, G::blockSize * G::blockSize> pixTable;
+    std::vector<float> svmWeights; // Orden del descriptor (bloques columna a columna)
+    float bias;
+    bool gamma;
+
+    std::vector<schar> qWeights; // Un bloque de qBlockSize por cada bloque de la ventana
+    float qScale;
+    bool quantized;
+
+    void buildPixTable();
+    void computeGradients(const cv::Mat& img, cv::Mat& grad, cv::Mat& qangle) const;
+    void blockHistogram(const cv::Mat& grad, const cv::Mat& qangle, int x0, int y0, float* hist) const;
+    static void normalizeBlock(float* hist);
+    static float dotBlock(const float* hist, const float* w);
+    static int dotBlockQ(const uchar* hist, const schar* w);
+
+public:
+    HOGKernel(const std::vector<float>& detector, bool gammaCorrection);
+
+    cv::Size winSize() const override { return cv::Size(G::winW, G::winH); }
+    int descriptorSize() const override { return G::descriptorSize; }
+
+    void compute(const cv::Mat& img, std::vector<float>& descriptor) const override;
+    void detect(const cv::Mat& img, std::vector<cv::Point>& hits, std::vector<double>& weights,
+                double hitThreshold, int winStride) const override;
+    void detectMultiScale(const cv::Mat& img, std::vector<cv::Rect>& found, std::vector<double>& weights,
+                          double hitThreshold, int winStride, double scale0, int groupThreshold,
+                          int padding) const override;
+
+    bool setQuantized(const QuantizedSVM& q) override;
+    bool isQuantized() const override { return quantized; }
+};
+
+template<class G>
+HOGKernel<G>::HOGKernel(const std::vector<float>& detector, bool gammaCorrection)
+    : bias(0.f), gamma(gammaCorrection), qScale(0.f), quantized(false) {
+    if ((int)detector.size() == G::descriptorSize + 1) {
+        svmWeights.assign(detector.begin(), detector.end() - 1);
+        bias = detector.back();
+    }
+    buildPixTable();
+}
+
+// Réplica de HOGCache::init: pesos gaussianos del bloque (sigma = (ancho+alto)/8) e
+// interpolación bilineal entre celdas. El orden (1 celda, 2 celdas, 4 celdas; x por fuera)
+// es el mismo que usa OpenCV para que la suma en flotante dé el mismo resultado.
+template<class G>
+void HOGKernel<G>::buildPixTable() {
+    constexpr int B = G::blockSize;
+    constexpr int C = G::cellsPerSide;
+    const float sigma = (float)(G::blockSize + G::blockSize) / 8.f;
+    const float scale = 1.f / (sigma * sigma * 2);
+
+    std::vector<PixEntry> one, two, four;
+    for (int j = 0; j < B; j++) {
+        for (int i = 0; i < B; i++) {
+            float di = i - B * 0.5f, dj = j - B * 0.5f;
+            float gw = std::exp(-(di * di + dj * dj) * scale);
+
+            float cellX = (j + 0.5f) / G::cellSize - 0.5f;
+            float cellY = (i + 0.5f) / G::cellSize - 0.5f;
+            int icellX0 = cvFloor(cellX), icellY0 = cvFloor(cellY);
+            int icellX1 = icellX0 + 1, icellY1 = icellY0 + 1;
+            cellX -= icellX0;
+            cellY -= icellY0;
+
+            PixEntry e;
+            e.dx = j;
+            e.dy = i;
+            auto ofs = [](int cx, int cy) { return (cx * C + cy) * G::nbins; };
+
+            if ((unsigned)icellX0 < (unsigned)C && (unsigned)icellX1 < (unsigned)C) {
+                if ((unsigned)icellY0 < (unsigned)C && (unsigned)icellY1 < (unsigned)C) {
+                    e.count = 4;
+                    e.histOfs[0] = ofs(icellX0, icellY0); e.weight[0] = (1.f - cellX) * (1.f - cellY);
+                    e.histOfs[1] = ofs(icellX1, icellY0); e.weight[1] = cellX * (1.f - cellY);
+                    e.histOfs[2] = ofs(icellX0, icellY1); e.weight[2] = (1.f - cellX) * cellY;
+                    e.histOfs[3] = ofs(icellX1, icellY1); e.weight[3] = cellX * cellY;
+                } else {
+                    if ((unsigned)icellY0 < (unsigned)C) { icellY1 = icellY0; cellY = 1.f - cellY; }
+                    e.count = 2;
+                    e.histOfs[0] = ofs(icellX0, icellY1); e.weight[0] = (1.f - cellX) * cellY;
+                    e.histOfs[1] = ofs(icellX1, icellY1); e.weight[1] = cellX * cellY;
+                }
+            } else {
+                if ((unsigned)icellX0 < (unsigned)C) { icellX1 = icellX0; cellX = 1.f - cellX; }
+                if ((unsigned)icellY0 < (unsigned)C && (unsigned)icellY1 < (unsigned)C) {
+                    e.count = 2;
+                    e.histOfs[0] = ofs(icellX1, icellY0); e.weight[0] = cellX * (1.f - cellY);
+                    e.histOfs[1] = ofs(icellX1, icellY1); e.weight[1] = cellX * cellY;
+                } else {
+                    if ((unsigned)icellY0 < (unsigned)C) { icellY1 = icellY0; cellY = 1.f - cellY; }
+                    e.count = 1;
+                    e.histOfs[0] = ofs(icellX1, icellY1); e.weight[0] = cellX * cellY;
+                }
+            }
+            for (int k = 0; k < e.count; k++) e.weight[k] = gw * e.weight[k];
+
+            if (e.count == 1) one.push_back(e);
+            else if (e.count == 2) two.push_back(e);
+            else four.push_back(e);
+        }
+    }
+
+    size_t n = 0;
+    for (const auto& e : one) pixTable[n++] = e;
+    for (const auto& e : two) pixTable[n++] = e;
+    for (const auto& e : four) pixTable[n++] = e;
+}
+
+// Gradiente centrado con borde REFLECT_101 y binning de orientación con interpolación lineal,
+// igual que HOGDescriptor::computeGradient. En color se usa el canal de mayor magnitud.
+template<class G>
+void HOGKernel<G>::computeGradients(const cv::Mat& img, cv::Mat& grad, cv::Mat& qangle) const {
+    using namespace cv; // intrínsecos universales (v_float32x4, v_load, ...)
+    CV_Assert(img.type() == CV_8UC1 || img.type() == CV_8UC3);
+    const int W = img.cols, H = img.rows, cn = img.channels();
+
+    float lut[256];
+    for (int i = 0; i < 256; i++) lut[i] = gamma ? std::sqrt((float)i) : (float)i;
+
+    std::vector<int> xmap(W + 2);
+    for (int x = -1; x <= W; x++) xmap[x + 1] = cv::borderInterpolate(x, W, cv::BORDER_REFLECT_101) * cn;
+
+    grad.create(H, W, CV_32FC2);
+    qangle.create(H, W, CV_8UC2);
+    cv::Mat Dx(1, W, CV_32F), Dy(1, W, CV_32F), Mag(1, W, CV_32F), Angle(1, W, CV_32F);
+    float* dx = Dx.ptr<float>();
+    float* dy = Dy.ptr<float>();
+    const float* mag = Mag.ptr<float>();
+    const float* ang = Angle.ptr<float>();
+    std::vector<int> h0(W), h1(W);
+
+    const float angleScale = (float)(G::nbins / CV_PI);
+
+    for (int y = 0; y < H; y++) {
+        const uchar* cur = img.ptr<uchar>(y);
+        const uchar* prev = img.ptr<uchar>(cv::borderInterpolate(y - 1, H, cv::BORDER_REFLECT_101));
+        const uchar* next = img.ptr<uchar>(cv::borderInterpolate(y + 1, H, cv::BORDER_REFLECT_101));
+
+        if (cn == 1) {
+            for (int x = 0; x < W; x++) {
+                dx[x] = lut[cur[xmap[x + 2]]] - lut[cur[xmap[x]]];
+                dy[x] = lut[next[xmap[x + 1]]] - lut[prev[xmap[x + 1]]];
+            }
+        } else {
+            for (int x = 0; x < W; x++) {
+                int xr = xmap[x + 2], xl = xmap[x], xc = xmap[x + 1];
+                float bx = lut[cur[xr + 2]] - lut[cur[xl + 2]];
+                float by = lut[next[xc + 2]] - lut[prev[xc + 2]];
+                float bm = bx * bx + by * by;
+                for (int c = 1; c >= 0; c--) {
+                    float cx = lut[cur[xr + c]] - lut[cur[xl + c]];
+                    float cy = lut[next[xc + c]] - lut[prev[xc + c]];
+                    float cm = cx * cx + cy * cy;
+                    if (bm < cm) { bx = cx; by = cy; bm = cm; }
+                }
+                dx[x] = bx;
+                dy[x] = by;
+            }
+        }
+
+        // Magnitud y ángulo vectorizados por OpenCV
+        cv::cartToPolar(Dx, Dy, Mag, Angle, false);
+
+        float* gptr = grad.ptr<float>(y);
+        uchar* qptr = qangle.ptr<uchar>(y);
+        int x = 0;
+#if CV_SIMD128
+        const v_float32x4 vscale = v_setall_f32(angleScale), vhalf = v_setall_f32(0.5f), vone = v_setall_f32(1.f);
+        const v_int32x4 vbins = v_setall_s32(G::nbins), vzero = v_setall_s32(0);
+        for (; x <= W - 4; x += 4) {
+            v_float32x4 a = v_load(ang + x) * vscale - vhalf;
+            v_int32x4 hidx = v_floor(a);
+            a = a - v_cvt_f32(hidx);
+            v_float32x4 m = v_load(mag + x);
+            v_store_interleave(gptr + x * 2, m * (vone - a), m * a);
+
+            hidx = v_select(hidx < vzero, hidx + vbins, v_select(hidx >= vbins, hidx - vbins, hidx));
+            v_int32x4 hnext = hidx + v_setall_s32(1);
+            hnext = v_select(hnext < vbins, hnext, vzero);
+            v_store(&h0[x], hidx);
+            v_store(&h1[x], hnext);
+        }
+#endif
+        for (; x < W; x++) {
+            float a = ang[x] * angleScale - 0.5f;
+            int hidx = cvFloor(a);
+            a -= hidx;
+            gptr[x * 2] = mag[x] * (1.f - a);
+            gptr[x * 2 + 1] = mag[x] * a;
+            if (hidx < 0) hidx += G::nbins;
+            else if (hidx >= G::nbins) hidx -= G::nbins;
+            h0[x] = hidx;
+            h1[x] = (hidx + 1 < G::nbins) ? hidx + 1 : 0;
+        }
+        for (x = 0; x < W; x++) {
+            qptr[x * 2] = (uchar)h0[x];
+            qptr[x * 2 + 1] = (uchar)h1[x];
+        }
+    }
+}
+
+template<class G>
+void HOGKernel<G>::blockHistogram(const cv::Mat& grad, const cv::Mat& qangle, int x0, int y0, float* hist) const {
+    std::memset(hist, 0, sizeof(float) * G::blockHistSize);
+    for (const PixEntry& p : pixTable) {
+        const float* a = grad.ptr<float>(y0 + p.dy) + (x0 + p.dx) * 2;
+        const uchar* h = qangle.ptr<uchar>(y0 + p.dy) + (x0 + p.dx) * 2;
+        const float a0 = a[0], a1 = a[1];
+        const int b0 = h[0], b1 = h[1];
+        for (int k = 0; k < p.count; k++) {
+            float* cell = hist + p.histOfs[k];
+            cell[b0] += a0 * p.weight[k];
+            cell[b1] += a1 * p.weight[k];
+        }
+    }
+}
+
+// L2-Hys (umbral 0.2), mismas constantes y mismo orden de suma (4 carriles) que OpenCV
+template<class G>
+void HOGKernel<G>::normalizeBlock(float* hist) {
+    using namespace cv;
+    constexpr int sz = G::blockHistSize;
+    const float thresh = 0.2f;
+    float partSum[4] = {0.f, 0.f, 0.f, 0.f};
+    int i = 0;
+#if CV_SIMD128
+    v_float32x4 s = v_setall_f32(0.f);
+    for (; i <= sz - 4; i += 4) {
+        v_float32x4 p = v_load(hist + i);
+        s = s + p * p;
+    }
+    v_store(partSum, s);
+#else
+    for (; i <= sz - 4; i += 4) {
+        for (int k = 0; k < 4; k++) partSum[k] += hist[i + k] * hist[i + k];
+    }
+#endif
+    float sum = (partSum[0] + partSum[1]) + (partSum[2] + partSum[3]);
+    for (; i < sz; i++) sum += hist[i] * hist[i];
+
+    float scale = 1.f / (std::sqrt(sum) + sz * 0.1f);
+    partSum[0] = partSum[1] = partSum[2] = partSum[3] = 0.f;
+    i = 0;
+#if CV_SIMD128
+    v_float32x4 vscale = v_setall_f32(scale), vthresh = v_setall_f32(thresh);
+    s = v_setall_f32(0.f);
+    for (; i <= sz - 4; i += 4) {
+        v_float32x4 p = v_min(vscale * v_load(hist + i), vthresh);
+        v_store(hist + i, p);
+        s = s + p * p;
+    }
+    v_store(partSum, s);
+#else
+    for (; i <= sz - 4; i += 4) {
+        for (int k = 0; k < 4; k++) {
+            hist[i + k] = std::min(hist[i + k] * scale, thresh);
+            partSum[k] += hist[i + k] * hist[i + k];
+        }
+    }
+#endif
+    sum = (partSum[0] + partSum[1]) + (partSum[2] + partSum[3]);
+    for (; i < sz; i++) {
+        hist[i] = std::min(hist[i] * scale, thresh);
+        sum += hist[i] * hist[i];
+    }
+
+    scale = 1.f / (std::sqrt(sum) + 1e-3f);
+    for (i = 0; i < sz; i++) hist[i] *= scale;
+}
+
+template<class G>
+float HOGKernel<G>::dotBlock(const float* hist, const float* w) {
+    using namespace cv;
+    constexpr int sz = G::blockHistSize;
+    float sum = 0.f;
+    int i = 0;
+#if CV_SIMD128
+    v_float32x4 s = v_setall_f32(0.f);
+    for (; i <= sz - 4; i += 4) s = v_muladd(v_load(hist + i), v_load(w + i), s);
+    sum = v_reduce_sum(s);
+#endif
+    for (; i < sz; i++) sum += hist[i] * w[i];
+    return sum;
+}
+
+template<class G>
+bool HOGKernel<G>::setQuantized(const QuantizedSVM& q) {
+    if ((int)q.weights.size() != G::descriptorSize) return false;
+
+    constexpr int nblocks = G::blocksX * G::blocksY;
+    qWeights.assign((size_t)nblocks * qBlockSize, 0);
+    for (int b = 0; b < nblocks; b++) {
+        std::memcpy(&qWeights[(size_t)b * qBlockSize], &q.weights[(size_t)b * G::blockHistSize], G::blockHistSize);
+    }
+    qScale = q.scale;
+    bias = q.bias;
+    quantized = true;
+    return true;
+}
+
+// uint8 x int8 -> int32: se expanden a int16 y se usa v_dotprod (pmaddwd en SSE2)
+template<class G>
+int HOGKernel<G>::dotBlockQ(const uchar* hist, const schar* w) {
+    using namespace cv;
+    int sum = 0;
+#if CV_SIMD128
+    v_int32x4 acc = v_setzero_s32();
+    for (int i = 0; i < qBlockSize; i += 16) {
+        v_uint16x8 d0, d1;
+        v_int16x8 w0, w1;
+        v_expand(v_load(hist + i), d0, d1);
+        v_expand(v_load(w + i), w0, w1);
+        acc += v_dotprod(v_reinterpret_as_s16(d0), w0) + v_dotprod(v_reinterpret_as_s16(d1), w1);
+    }
+    sum = v_reduce_sum(acc);
+#else
+    for (int i = 0; i < G::blockHistSize; i++) sum += (int)hist[i] * (int)w[i];
+#endif
+    return sum;
+}
+
+template<class G>
+void HOGKernel<G>::compute(const cv::Mat& img, std::vector<float>& descriptor) const {
+    CV_Assert(img.cols == G::winW && img.rows == G::winH);
+    cv::Mat grad, qangle;
+    computeGradients(img, grad, qangle);
+
+    descriptor.resize(G::descriptorSize);
+    float* dst = descriptor.data();
+    for (int bx = 0; bx < G::blocksX; bx++) {
+        for (int by = 0; by < G::blocksY; by++) {
+            blockHistogram(grad, qangle, bx * G::blockStride, by * G::blockStride, dst);
+            normalizeBlock(dst);
+            dst += G::blockHistSize;
+        }
+    }
+}
+
+template<class G>
+void HOGKernel<G>::detect(const cv::Mat& img, std::vector<cv::Point>& hits, std::vector<double>& weights,
+                          double hitThreshold, int winStride) const {
+    hits.clear();
+    weights.clear();
+    CV_Assert(!svmWeights.empty() || quantized);
+    if (img.cols < G::winW || img.rows < G::winH) return;
+
+    // La ventana avanza en múltiplos del paso de bloque para reutilizar los bloques
+    const int step = std::max(1, winStride / G::blockStride);
+    const int gridX = (img.cols - G::blockSize) / G::blockStride + 1;
+    const int gridY = (img.rows - G::blockSize) / G::blockStride + 1;
+    const int winsX = (gridX - G::blocksX) / step + 1;
+    const int winsY = (gridY - G::blocksY) / step + 1;
+
+    cv::Mat grad, qangle;
+    computeGradients(img, grad, qangle);
+
+    std::vector<double> scores((size_t)winsX * winsY, (double)bias);
+    std::vector<int> qscores(quantized ? (size_t)winsX * winsY : 0, 0);
+    alignas(16) float hist[G::blockHistSize];
+    alignas(16) uchar qhist[qBlockSize] = {0};
+
+    for (int bx = 0; bx < gridX; bx++) {
+        for (int by = 0; by < gridY; by++) {
+            // Solo bloques que pertenecen a alguna ventana del recorrido
+            int wxMax = std::min(bx, (winsX - 1) * step), wyMax = std::min(by, (winsY - 1) * step);
+            if (bx - G::blocksX + 1 > wxMax || by - G::blocksY + 1 > wyMax) continue;
+
+            blockHistogram(grad, qangle, bx * G::blockStride, by * G::blockStride, hist);
+            normalizeBlock(hist);
+            if (quantized) {
+                for (int i = 0; i < G::blockHistSize; i++) qhist[i] = quantizeFeature(hist[i]);
+            }
+
+            // Este bloque es el bloque local (lx, ly) de la ventana (bx - lx, by - ly)
+            for (int lx = 0; lx < G::blocksX; lx++) {
+                int wx = bx - lx;
+                if (wx < 0) break;
+                if (wx % step != 0 || wx / step >= winsX) continue;
+                for (int ly = 0; ly < G::blocksY; ly++) {
+                    int wy = by - ly;
+                    if (wy < 0) break;
+                    if (wy % step != 0 || wy / step >= winsY) continue;
+                    size_t win = (size_t)(wy / step) * winsX + wx / step;
+                    int local = lx * G::blocksY + ly;
+                    if (quantized) {
+                        qscores[win] += dotBlockQ(qhist, qWeights.data() + (size_t)local * qBlockSize);
+                    } else {
+                        scores[win] += dotBlock(hist, svmWeights.data() + (size_t)local * G::blockHistSize);
+                    }
+                }
+            }
+        }
+    }
+
+    const double qFactor = qScale / 255.0;
+    for (int wy = 0; wy < winsY; wy++) {
+        for (int wx = 0; wx < winsX; wx++) {
+            size_t win = (size_t)wy * winsX + wx;
+            double s = quantized ? bias + qscores[win] * qFactor : scores[win];
+            if (s < hitThreshold) continue;
+            hits.push_back(cv::Point(wx * step * G::blockStride, wy * step * G::blockStride));
+            weights.push_back(s);
+        }
+    }
+}
+
+template<class G>
+void HOGKernel<G>::detectMultiScale(const cv::Mat& img, std::vector<cv::Rect>& found, std::vector<double>& weights,
+                                    double hitThreshold, int winStride, double scale0, int groupThreshold,
+                                    int padding) const {
+    found.clear();
+    weights.clear();
+
+    // Mismas escalas que HOGDescriptor::detectMultiScale
+    std::vector<double> scales;
+    for (double scale = 1.0; ; scale *= scale0) {
+        if (cvRound(img.cols / scale) < G::winW || cvRound(img.rows / scale) < G::winH) break;
+        scales.push_back(scale);
+        if (scale0 <= 1.0) break;
+    }
+
+    // Un nivel por tarea; los resultados se concatenan en el orden de la pirámide
+    std::vector<std::vector<cv::Rect>> levelFound(scales.size());
+    std::vector<std::vector<double>> levelWeights(scales.size());
+    padding = std::max(padding, 0);
+    cv::parallel_for_(cv::Range(0, (int)scales.size()), [&](const cv::Range& range) {
+        cv::Mat level;
+        std::vector<cv::Point> hits;
+        for (int li = range.start; li < range.end; li++) {
+            const double scale = scales[li];
+            cv::Size sz(cvRound(img.cols / scale), cvRound(img.rows / scale));
+            if (sz == img.size()) level = img;
+            else cv::resize(img, level, sz, 0, 0, cv::INTER_LINEAR);
+            if (padding > 0) {
+                cv::copyMakeBorder(level, level, padding, padding, padding, padding, cv::BORDER_REFLECT_101);
+            }
+
+            detect(level, hits, levelWeights[li], hitThreshold, winStride);
+            for (const auto& p : hits) {
+                levelFound[li].push_back(cv::Rect(cvRound((p.x - padding) * scale), cvRound((p.y - padding) * scale),
+                                                  cvRound(G::winW * scale), cvRound(G::winH * scale)));
+            }
+        }
+    });
+
+    for (size_t li = 0; li < scales.size(); li++) {
+        found.insert(found.end(), levelFound[li].begin(), levelFound[li].end());
+        weights.insert(weights.end(), levelWeights[li].begin(), levelWeights[li].end());
+    }
+
+    if (groupThreshold > 0) groupHOGRectangles(found, weights, groupThreshold);
+}
+
+#endif
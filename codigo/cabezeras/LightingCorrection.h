@@ -0,0 +1,84 @@
+#ifndef LIGHTING_CORRECTION_H
+#define LIGHTING_CORRECTION_H
+
+#include <opencv2/opencv.hpp>
+#include <array>
+
+// --- ANÁLISIS DE ILUMINACIÓN ---
+struct LightingAnalysis {
+    double meanBrightness;
+    double stdDevBrightness;
+    bool isBacklit;
+    bool isOverexposed;
+    bool isUnderexposed;
+    bool hasHighContrast;
+    double dynamicRange;
+    // Estadísticas de las que salen los flags (para aplicar histéresis)
+    double darkFraction;
+    double brightFraction;
+    double edgeCenterDiff; // Brillo del borde superior menos el del centro
+};
+
+LightingAnalysis analyzeLighting(const cv::Mat& gray);
+
+// Modo de corrección, con la misma prioridad que correctLighting
+enum class LightingMode { NORMAL, BACKLIT, OVEREXPOSED, UNDEREXPOSED };
+
+LightingMode lightingMode(const LightingAnalysis& analysis);
+
+// Configuración de corrección de un modo ya construida (CLAHE + LUT de gamma/ganancia)
+class LightingCorrector {
+private:
+    cv::Ptr<cv::CLAHE> clahe;
+    cv::Mat lut; // Vacía = sin LUT
+
+public:
+    explicit LightingCorrector(LightingMode mode = LightingMode::NORMAL);
+    void apply(const cv::Mat& input, cv::Mat& output);
+};
+
+// --- CORRECCIÓN AUTOMÁTICA DE ILUMINACIÓN ---
+cv::Mat correctLighting(const cv::Mat& input, const LightingAnalysis& analysis);
+
+// Iluminación incremental: la luz cambia despacio, así que el análisis completo (sobre 1 de
+// cada rowStep filas) solo se repite cada fullEvery frames o cuando el brillo medio se desvía.
+// El modo cambia con histéresis y tras confirmFrames análisis seguidos, y cada modo tiene su
+// CLAHE/LUT ya construido: la entrada del detector no parpadea entre correcciones.
+class LightingTracker {
+private:
+    int fullEvery;
+    int rowStep;
+    double driftThreshold; // Niveles de gris de desvío que fuerzan un análisis
+    int confirmFrames;
+
+    LightingAnalysis analysis;  // Último análisis completo
+    LightingMode mode;
+    LightingMode candidate;
+    int candidateCount;
+    double referenceMean;       // Brillo medio cuando se hizo el último análisis
+    double meanBrightness;      // Brillo medio de este frame (submuestreado)
+    int framesSinceFull;
+    bool analyzedThisFrame;
+    long long fullAnalyses;
+    std::array<LightingCorrector, 4> correctors;
+
+    cv::Mat subsample(const cv::Mat& gray) const;
+    LightingMode classify(const LightingAnalysis& a) const;
+
+public:
+    LightingTracker(int _fullEvery = 15, int _rowStep = 4, double _driftThreshold = 8.0, int _confirmFrames = 3);
+
+    // Actualiza con el frame en gris y devuelve el modo estabilizado
+    LightingMode update(const cv::Mat& gray);
+
+    // Corrige con la configuración cacheada del modo actual
+    void correct(const cv::Mat& input, cv::Mat& output);
+
+    LightingMode getMode() const { return mode; }
+    const LightingAnalysis& getAnalysis() const { return analysis; }
+    double getMeanBrightness() const { return meanBrightness; }
+    bool analyzedLastFrame() const { return analyzedThisFrame; }
+    long long getFullAnalyses() const { return fullAnalyses; }
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef POSE_CLIENT_H
+#define POSE_CLIENT_H
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Recorte de una detección positiva junto con sus metadatos
+struct PoseCrop {
+    cv::Mat image;
+    std::vector<uchar> jpeg; // Si ya viene codificado (spool), se envía tal cual
+    cv::Rect box;       // Caja en coordenadas del frame original
+    double confidence;  // Peso HOG
+    long long timestampMs; // Momento de la captura (ms desde epoch)
+};
+
+// Resultado por recorte devuelto por la API
+struct PoseResult {
+    int index;      // Posición del recorte dentro del lote
+    bool detected;  // La API confirmó una pose válida
+    int keypoints;  // Puntos clave con confianza suficiente
+};
+
+class PoseClient {
+private:
+    std::string baseUrl;
+    long timeoutSec;
+
+public:
+    // Constructor: baseUrl sin la ruta final (ej: http://localhost:8000)
+    PoseClient(std::string _baseUrl = "http://localhost:8000", long _timeoutSec = 2);
+
+    // Codifica un recorte a JPEG tal como lo espera la API
+    static std::vector<uchar> encodeCrop(const cv::Mat& crop);
+
+    // Todos los recortes en una sola petición multipart (/detect_batch).
+    // Devuelve true si la API respondió y la respuesta se pudo interpretar.
+    bool sendBatch(const std::vector<PoseCrop>& crops, std::vector<PoseResult>& results);
+};
+
+// Acumula recortes de uno o varios frames y decide cuándo enviar el lote
+class PoseBatcher {
+private:
+    std::vector<PoseCrop> pending;
+    std::chrono::steady_clock::time_point firstAdded;
+    int windowMs;
+    size_t maxCrops;
+
+public:
+    // windowMs = 0 envía los recortes de cada frame en cuanto llegan
+    PoseBatcher(int _windowMs = 0, size_t _maxCrops = 8);
+
+    // Copia el recorte (el frame se sigue dibujando después)
+    void add(const cv::Mat& crop, cv::Rect box, double confidence);
+
+    // true si la ventana venció o el lote está lleno
+    bool due() const;
+
+    // Entrega el lote pendiente y lo vacía
+    std::vector<PoseCrop> take();
+};
+
+#endif
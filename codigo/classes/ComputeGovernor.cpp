@@ -0,0 +1,114 @@
+/**
+ * codigo/classes/ComputeGovernor.cpp
+ * Ajusta las perillas de detección para mantener un objetivo de FPS / tope de CPU.
+ */
+
+#include "../cabezeras/ComputeGovernor.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+// --- PARÁMETROS DE DECISIÓN ---
+const double EMA_ALPHA = 0.2;        // Peso del frame más reciente en la media
+const double HEADROOM_RATIO = 0.7;   // Relajar solo si sobra >30% del presupuesto
+const double CPU_HEADROOM = 15.0;    // ...y la CPU está 15 puntos bajo el tope
+const int DEGRADE_AFTER = 8;         // Frames seguidos sobre presupuesto para degradar
+const int CPU_DEGRADE_SAMPLES = 2;   // Muestras de CPU seguidas sobre el tope para degradar
+const int RELAX_AFTER = 45;          // Frames seguidos con margen para relajar
+const int COOLDOWN_FRAMES = 20;      // Espera tras cada cambio (deja asentar la media)
+
+ComputeGovernor::ComputeGovernor(double _targetFPS, double _cpuCap)
+    : currentLevel(0), targetFPS(_targetFPS), cpuCap(_cpuCap), avgFrameMs(0.0),
+      overBudgetFrames(0), headroomFrames(0), cooldown(0), lastCpu(0.0), cpuOverSamples(0) {
+    // Escalera de calidad: cada nivel es más barato que el anterior.
+    // El nivel 0 reproduce la configuración fija original (1.05, 8x8, puntos cada 5).
+    //          escala stride detectar puntos  reducción
+    levels = {
+        {1.05,  8,  1,  5,  1.00},
+        {1.08,  8,  1,  8,  1.00},
+        {1.10, 16,  1, 10,  1.00},
+        {1.15, 16,  2, 10,  0.85},
+        {1.20, 16,  2, 15,  0.75},
+        {1.25, 16,  3, 20,  0.65},
+        {1.30, 16,  4, 30,  0.50},
+    };
+}
+
+bool ComputeGovernor::update(const StageTimings& timings, double cpuUsage) {
+    avgFrameMs = (avgFrameMs <= 0.0) ? timings.totalMs
+                                     : EMA_ALPHA * timings.totalMs + (1.0 - EMA_ALPHA) * avgFrameMs;
+
+    // La CPU se muestrea cada pocos frames: se cuentan muestras reales, no frames, para que
+    // una sola lectura alta no se repita hasta completar DEGRADE_AFTER. Las muestras se
+    // registran también durante el enfriamiento (solo las decisiones esperan).
+    if (cpuUsage >= 0) {
+        lastCpu = cpuUsage;
+        cpuOverSamples = (cpuCap > 0 && cpuUsage > cpuCap) ? cpuOverSamples + 1 : 0;
+    }
+
+    if (cooldown > 0) {
+        cooldown--;
+        return false;
+    }
+
+    double budgetMs = (targetFPS > 0) ? 1000.0 / targetFPS : 0.0;
+    bool fpsOver = budgetMs > 0 && avgFrameMs > budgetMs;
+    bool cpuOver = cpuOverSamples >= CPU_DEGRADE_SAMPLES;
+    bool fpsHeadroom = budgetMs <= 0 || avgFrameMs < budgetMs * HEADROOM_RATIO;
+    bool cpuHeadroom = cpuCap <= 0 || lastCpu < cpuCap - CPU_HEADROOM;
+
+    if (fpsOver || cpuOver) {
+        overBudgetFrames++;
+        headroomFrames = 0;
+    } else if (fpsHeadroom && cpuHeadroom) {
+        headroomFrames++;
+        overBudgetFrames = 0;
+    } else {
+        // Dentro de la banda de histéresis: mantener el nivel actual
+        overBudgetFrames = 0;
+        headroomFrames = 0;
+    }
+
+    bool degrade = (fpsOver && overBudgetFrames >= DEGRADE_AFTER) || cpuOver;
+    if (degrade && currentLevel + 1 < (int)levels.size()) {
+        std::ostringstream reason;
+        reason << std::fixed << std::setprecision(1);
+        if (fpsOver) reason << "frame " << avgFrameMs << " ms > " << budgetMs << " ms";
+        if (fpsOver && cpuOver) reason << ", ";
+        if (cpuOver) reason << "CPU " << lastCpu << "% > " << cpuCap << "%";
+        changeLevel(currentLevel + 1, reason.str(), timings);
+        return true;
+    }
+
+    if (headroomFrames >= RELAX_AFTER && currentLevel > 0) {
+        std::ostringstream reason;
+        reason << std::fixed << std::setprecision(1)
+               << "margen: frame " << avgFrameMs << " ms, CPU " << lastCpu << "%";
+        changeLevel(currentLevel - 1, reason.str(), timings);
+        return true;
+    }
+
+    return false;
+}
+
+void ComputeGovernor::changeLevel(int newLevel, const std::string& reason, const StageTimings& t) {
+    int oldLevel = currentLevel;
+    currentLevel = newLevel;
+    overBudgetFrames = 0;
+    headroomFrames = 0;
+    cpuOverSamples = 0;
+    cooldown = COOLDOWN_FRAMES;
+
+    const DetectionKnobs& k = levels[currentLevel];
+    std::ostringstream msg;
+    msg << std::fixed << std::setprecision(2)
+        << "⚙️  Governor: nivel " << oldLevel << " -> " << newLevel
+        << (newLevel > oldLevel ? " (degradar)" : " (relajar)")
+        << " | " << reason
+        << " | luz " << t.lightingMs << " ms, puntos " << t.featuresMs
+        << " ms, HOG " << t.detectionMs << " ms"
+        << " | escala " << k.hogScale << ", stride " << k.winStride
+        << ", detectar 1/" << k.detectEvery << ", puntos 1/" << k.featureEvery
+        << ", reducción " << k.downscale;
+    std::cout << msg.str() << std::endl;
+}
@@ -0,0 +1,66 @@
+/**
+ * codigo/classes/DetectionFilters.cpp
+ * Filtro de tamaño/forma por zona y supresión no máxima de las detecciones HOG.
+ */
+
+#include "../cabezeras/DetectionFilters.h"
+#include <algorithm>
+#include <numeric>
+
+bool isValidDetection(cv::Rect r, double weight, int frameWidth, int frameHeight, const ZoneFilter& f) {
+    if (weight < f.minConfidence) return false;
+
+    int minWidth = frameWidth * f.minWidth;
+    int maxWidth = frameWidth * f.maxWidth;
+    int minHeight = frameHeight * f.minHeight;
+    int maxHeight = frameHeight * f.maxHeight;
+
+    if (r.width < minWidth || r.width > maxWidth) return false;
+    if (r.height < minHeight || r.height > maxHeight) return false;
+
+    float aspectRatio = (float)r.height / (float)r.width;
+    if (aspectRatio < f.minAspect || aspectRatio > f.maxAspect) return false;
+
+    int minArea = (frameWidth * frameHeight) * f.minArea;
+    if (r.area() < minArea) return false;
+
+    return true;
+}
+
+float computeIoU(const cv::Rect& a, const cv::Rect& b) {
+    int inter = (a & b).area();
+    int uni = a.area() + b.area() - inter;
+    return uni > 0 ? (float)inter / (float)uni : 0.f;
+}
+
+std::vector<cv::Rect> improvedNMS(std::vector<cv::Rect>& boxes, std::vector<double>& weights, float overlapThresh) {
+    if (boxes.empty()) return {};
+
+    std::vector<cv::Rect> result;
+    std::vector<int> indices(boxes.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::sort(indices.begin(), indices.end(), [&weights](int i1, int i2) {
+        return weights[i1] > weights[i2];
+    });
+
+    std::vector<bool> suppressed(boxes.size(), false);
+
+    for (size_t i = 0; i < indices.size(); i++) {
+        int idx = indices[i];
+        if (suppressed[idx]) continue;
+
+        result.push_back(boxes[idx]);
+
+        for (size_t j = i + 1; j < indices.size(); j++) {
+            int idx2 = indices[j];
+            if (suppressed[idx2]) continue;
+
+            if (computeIoU(boxes[idx], boxes[idx2]) > overlapThresh) {
+                suppressed[idx2] = true;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,352 @@
+/**
+ * codigo/classes/DetectionSpool.cpp
+ * Spool en disco a prueba de caídas + hilo de envío asíncrono con backoff.
+ */
+
+#include "../cabezeras/DetectionSpool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// --- CONFIGURACIÓN ---
+const uint32_t RECORD_MAGIC = 0x31505344;          // "DSP1"
+const uint32_t MAX_RECORD_BYTES = 16u << 20;       // Cualquier longitud mayor es basura
+const int BACKOFF_MIN_MS = 500;
+const int BACKOFF_MAX_MS = 30000;
+const long long SAME_CAPTURE_MS = 20; // Recortes de un mismo frame llegan con ms de diferencia
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t length;     // Bytes del JPEG que siguen a la cabecera
+    int64_t timestampMs;
+    float confidence;
+    int32_t x, y, w, h;
+    uint32_t crc;        // CRC32 de la cabecera (con crc = 0) + JPEG
+};
+static_assert(sizeof(RecordHeader) == 40, "RecordHeader debe ocupar 40 bytes en disco");
+
+static uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t len) {
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        ready = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint32_t recordCRC(RecordHeader h, const unsigned char* jpeg, size_t len) {
+    h.crc = 0;
+    uint32_t crc = crc32Update(0, reinterpret_cast<const unsigned char*>(&h), sizeof(h));
+    return crc32Update(crc, jpeg, len);
+}
+
+DetectionSpool::DetectionSpool(std::string _dir, PoseClient _client, size_t _maxBytes,
+                               size_t _segmentBytes, size_t _batchSize, int _captureSpanMs)
+    : dir(_dir), maxBytes(_maxBytes), segmentBytes(_segmentBytes), batchSize(_batchSize),
+      captureSpanMs(std::max((long long)_captureSpanMs, SAME_CAPTURE_MS)),
+      client(_client), totalBytes(0), active(nullptr), activeSeq(1), activeAcked(0), uploadingSeq(0),
+      evictedRecords(0), running(false) {}
+
+DetectionSpool::~DetectionSpool() {
+    stop();
+}
+
+std::string DetectionSpool::segmentPath(unsigned long long seq) const {
+    char name[32];
+    snprintf(name, sizeof(name), "spool_%012llu.seg", seq);
+    return dir + "/" + name;
+}
+
+std::string DetectionSpool::ackPath(unsigned long long seq) const {
+    char name[32];
+    snprintf(name, sizeof(name), "spool_%012llu.ack", seq);
+    return dir + "/" + name;
+}
+
+void DetectionSpool::start() {
+    if (running) return;
+    recover();
+    running = true;
+    uploader = std::thread(&DetectionSpool::uploadLoop, this);
+}
+
+void DetectionSpool::stop() {
+    if (uploader.joinable()) {
+        {
+            // Bajo el candado: el hilo no puede perder el aviso entre evaluar running y esperar
+            std::lock_guard<std::mutex> lock(mtx);
+            running = false;
+        }
+        wake.notify_all();
+        uploader.join();
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (active) {
+        fclose(active);
+        active = nullptr;
+    }
+}
+
+void DetectionSpool::recover() {
+    std::lock_guard<std::mutex> lock(mtx);
+    fs::create_directories(dir);
+
+    unsigned long long maxSeq = 0;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        std::string name = entry.path().filename().string();
+        unsigned long long seq;
+        if (sscanf(name.c_str(), "spool_%llu.seg", &seq) != 1 || entry.path().extension() != ".seg") continue;
+        size_t bytes = (size_t)fs::file_size(entry.path());
+        segments[seq] = bytes;
+        totalBytes += bytes;
+        maxSeq = std::max(maxSeq, seq);
+    }
+    // Cada ejecución escribe en un segmento nuevo: los anteriores quedan sellados tal cual
+    activeSeq = maxSeq + 1;
+
+    if (!segments.empty()) {
+        std::cout << "💾 Spool: recuperados " << segments.size() << " segmentos ("
+                  << totalBytes / 1024 << " KB) pendientes de enviar" << std::endl;
+    }
+}
+
+bool DetectionSpool::openActive() {
+    active = fopen(segmentPath(activeSeq).c_str(), "ab");
+    if (!active) {
+        std::cerr << "❌ Spool: no se pudo abrir " << segmentPath(activeSeq) << std::endl;
+        return false;
+    }
+    segments[activeSeq] = 0;
+    activeAcked = 0;
+    return true;
+}
+
+void DetectionSpool::sealActive() {
+    if (!active) return;
+    fclose(active);
+    active = nullptr;
+    if (segments[activeSeq] == 0) removeSegment(activeSeq);
+    activeSeq++;
+}
+
+void DetectionSpool::removeSegment(unsigned long long seq) {
+    auto it = segments.find(seq);
+    if (it == segments.end()) return;
+    totalBytes -= it->second;
+    segments.erase(it);
+    std::error_code ec;
+    fs::remove(segmentPath(seq), ec);
+    fs::remove(ackPath(seq), ec);
+}
+
+bool DetectionSpool::evictOldest() {
+    // Política: se pierde primero lo más antiguo, nunca el segmento que se está enviando
+    for (const auto& seg : segments) {
+        unsigned long long seq = seg.first;
+        if (seq == uploadingSeq || (active && seq == activeSeq)) continue;
+
+        size_t lost = countRecords(seq, readAck(seq));
+        evictedRecords += (long long)lost;
+        std::cerr << "⚠️  Spool lleno: desalojado segmento " << seq << " (" << lost
+                  << " recortes sin enviar)" << std::endl;
+        removeSegment(seq);
+        return true;
+    }
+    return false;
+}
+
+bool DetectionSpool::append(const std::vector<PoseCrop>& crops) {
+    if (crops.empty()) return true;
+
+    // Codificar fuera del candado: el hilo de envío no debe esperar al JPEG
+    std::vector<unsigned char> buffer;
+    for (const auto& c : crops) {
+        std::vector<uchar> jpeg = c.jpeg.empty() ? PoseClient::encodeCrop(c.image) : c.jpeg;
+        RecordHeader h;
+        h.magic = RECORD_MAGIC;
+        h.length = (uint32_t)jpeg.size();
+        h.timestampMs = c.timestampMs;
+        h.confidence = (float)c.confidence;
+        h.x = c.box.x; h.y = c.box.y; h.w = c.box.width; h.h = c.box.height;
+        h.crc = recordCRC(h, jpeg.data(), jpeg.size());
+        const unsigned char* hp = reinterpret_cast<const unsigned char*>(&h);
+        buffer.insert(buffer.end(), hp, hp + sizeof(h));
+        buffer.insert(buffer.end(), jpeg.begin(), jpeg.end());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        while (totalBytes + buffer.size() > maxBytes) {
+            if (!evictOldest()) {
+                std::cerr << "⚠️  Spool lleno: lote de " << crops.size() << " recortes descartado" << std::endl;
+                return false;
+            }
+        }
+        if (!active && !openActive()) return false;
+
+        // Una sola escritura por lote + fsync: tras volver, el lote sobrevive a una caída
+        bool ok = fwrite(buffer.data(), 1, buffer.size(), active) == buffer.size() &&
+                  fflush(active) == 0 && fsync(fileno(active)) == 0;
+        if (!ok) {
+            std::cerr << "❌ Spool: error de escritura en " << segmentPath(activeSeq) << std::endl;
+            sealActive();
+            return false;
+        }
+        segments[activeSeq] += buffer.size();
+        totalBytes += buffer.size();
+        if (segments[activeSeq] >= segmentBytes) sealActive();
+    }
+    wake.notify_one();
+    return true;
+}
+
+size_t DetectionSpool::readAck(unsigned long long seq) const {
+    size_t offset = 0;
+    std::ifstream ack(ackPath(seq));
+    if (ack.is_open()) ack >> offset;
+    return offset;
+}
+
+void DetectionSpool::writeAck(unsigned long long seq, size_t offset) const {
+    // Escritura atómica: archivo temporal + rename
+    std::string tmp = ackPath(seq) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) return;
+    fprintf(f, "%zu\n", offset);
+    fflush(f);
+    fsync(fileno(f));
+    fclose(f);
+    std::error_code ec;
+    fs::rename(tmp, ackPath(seq), ec);
+}
+
+size_t DetectionSpool::countRecords(unsigned long long seq, size_t offset) const {
+    FILE* f = fopen(segmentPath(seq).c_str(), "rb");
+    if (!f) return 0;
+    size_t count = 0;
+    if (fseek(f, (long)offset, SEEK_SET) == 0) {
+        // Solo cabeceras: los JPEG se saltan con fseek (esto corre dentro de append())
+        RecordHeader h;
+        while (fread(&h, sizeof(h), 1, f) == 1 && h.magic == RECORD_MAGIC && h.length <= MAX_RECORD_BYTES) {
+            if (fseek(f, (long)h.length, SEEK_CUR) != 0) break;
+            count++;
+        }
+    }
+    fclose(f);
+    return count;
+}
+
+size_t DetectionSpool::readRecords(unsigned long long seq, size_t offset, size_t limit, size_t max,
+                                   std::vector<PoseCrop>& out, long long maxSpanMs) const {
+    FILE* f = fopen(segmentPath(seq).c_str(), "rb");
+    if (!f) return offset;
+    if (fseek(f, (long)offset, SEEK_SET) != 0) {
+        fclose(f);
+        return offset;
+    }
+
+    while (out.size() < max) {
+        RecordHeader h;
+        if (offset + sizeof(h) > limit || fread(&h, sizeof(h), 1, f) != 1) break;
+        if (h.magic != RECORD_MAGIC || h.length > MAX_RECORD_BYTES) break;
+        if (offset + sizeof(h) + h.length > limit) break;
+        // Otra captura: queda para la siguiente petición (la API alerta una vez por petición)
+        if (maxSpanMs >= 0 && !out.empty() && std::llabs(h.timestampMs - out.front().timestampMs) > maxSpanMs) break;
+
+        std::vector<uchar> jpeg(h.length);
+        if (h.length > 0 && fread(jpeg.data(), 1, h.length, f) != h.length) break;
+        if (recordCRC(h, jpeg.data(), jpeg.size()) != h.crc) {
+            std::cerr << "⚠️  Spool: registro corrupto en segmento " << seq << ", se descarta el resto" << std::endl;
+            break;
+        }
+
+        out.push_back({cv::Mat(), jpeg, cv::Rect(h.x, h.y, h.w, h.h), h.confidence, h.timestampMs});
+        offset += sizeof(h) + h.length;
+    }
+    fclose(f);
+    return offset;
+}
+
+void DetectionSpool::uploadLoop() {
+    int backoffMs = BACKOFF_MIN_MS;
+
+    // Hay algo que enviar: un segmento sellado (aunque sea para borrarlo) o bytes sin
+    // confirmar en el activo
+    auto hasWork = [this] {
+        if (segments.empty()) return false;
+        auto oldest = segments.begin();
+        return !(active && oldest->first == activeSeq) || oldest->second > activeAcked;
+    };
+
+    while (running) {
+        unsigned long long seq;
+        size_t limit;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (!wake.wait_for(lock, std::chrono::seconds(1), [&] { return !running || hasWork(); })) continue;
+            if (!running) break;
+            // Los segmentos son append-only y cada lote se sincroniza antes de contarlo:
+            // el activo se lee en caliente hasta los bytes escritos en este momento
+            seq = segments.begin()->first;
+            limit = segments.begin()->second;
+            uploadingSeq = seq;
+        }
+
+        size_t offset = readAck(seq);
+        std::vector<PoseCrop> batch;
+        size_t next = readRecords(seq, offset, limit, batchSize, batch, captureSpanMs);
+
+        if (batch.empty()) {
+            // Segmento agotado (o cola truncada por una caída): se elimina. Un activo sin
+            // registros legibles antes de su tamaño está dañado y se sella antes de borrarlo.
+            std::lock_guard<std::mutex> lock(mtx);
+            if (active && seq == activeSeq) sealActive();
+            removeSegment(seq);
+            uploadingSeq = 0;
+            continue;
+        }
+
+        std::vector<PoseResult> results;
+        if (client.sendBatch(batch, results)) {
+            writeAck(seq, next);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (active && seq == activeSeq) activeAcked = next;
+            }
+            backoffMs = BACKOFF_MIN_MS;
+            int confirmed = 0;
+            for (const auto& r : results) if (r.detected) confirmed++;
+            std::cout << "📡 API Sent | Lote: " << batch.size() << " | Poses: " << confirmed << std::endl;
+        } else {
+            std::cerr << "⚠️  API sin respuesta, reintento en " << backoffMs << " ms" << std::endl;
+            std::unique_lock<std::mutex> lock(mtx);
+            uploadingSeq = 0;
+            wake.wait_for(lock, std::chrono::milliseconds(backoffMs), [this] { return !running; });
+            backoffMs = std::min(backoffMs * 2, BACKOFF_MAX_MS);
+        }
+    }
+}
+
+size_t DetectionSpool::pendingBytes() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return totalBytes;
+}
+
+long long DetectionSpool::getEvictedRecords() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return evictedRecords;
+}
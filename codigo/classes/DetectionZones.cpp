@@ -0,0 +1,238 @@
+/**
+ * codigo/classes/DetectionZones.cpp
+ * Zonas de interés por cámara: barrido HOG restringido a cada zona y a sus escalas.
+ */
+
+#include "../cabezeras/DetectionZones.h"
+#include "../cabezeras/HOGKernel.h"
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+
+// --- CONFIGURACIÓN ---
+const int HOG_PADDING = 32; // Mismo padding que usaba detectMultiScale (px de cada nivel)
+
+ZoneSet::ZoneSet() : configured(false) {
+    DetectionZone full;
+    full.name = "frame";
+    full.polygon = {{0.f, 0.f}, {1.f, 0.f}, {1.f, 1.f}, {0.f, 1.f}};
+    zones.push_back(full);
+}
+
+static void readKey(const cv::FileNode& node, const char* key, double& value) {
+    if (!node[key].empty()) value = (double)node[key];
+}
+
+bool ZoneSet::load(const std::string& path) {
+    cv::FileStorage fs;
+    try {
+        if (!fs.open(path, cv::FileStorage::READ)) return false;
+    } catch (const cv::Exception&) {
+        std::cerr << "❌ Zonas: " << path << " no es un YAML válido" << std::endl;
+        return false;
+    }
+
+    cv::FileNode list = fs["zones"];
+    if (list.type() != cv::FileNode::SEQ) {
+        std::cerr << "❌ Zonas: " << path << " no tiene la lista 'zones'" << std::endl;
+        return false;
+    }
+
+    std::vector<DetectionZone> loaded;
+    for (const auto& node : list) {
+        DetectionZone z;
+        z.name = node["name"].empty() ? "zona" + std::to_string(loaded.size()) : (std::string)node["name"];
+
+        std::vector<float> coords;
+        node["polygon"] >> coords;
+        if (coords.size() < 6 || coords.size() % 2 != 0) {
+            std::cerr << "⚠️  Zonas: '" << z.name << "' necesita al menos 3 vértices, se ignora" << std::endl;
+            continue;
+        }
+        for (size_t i = 0; i < coords.size(); i += 2) {
+            z.polygon.push_back(cv::Point2f(std::clamp(coords[i], 0.f, 1.f), std::clamp(coords[i + 1], 0.f, 1.f)));
+        }
+
+        ZoneFilter& f = z.filter;
+        readKey(node, "hitThreshold", f.hitThreshold);
+        readKey(node, "minConfidence", f.minConfidence);
+        readKey(node, "minWidth", f.minWidth);
+        readKey(node, "maxWidth", f.maxWidth);
+        readKey(node, "minHeight", f.minHeight);
+        readKey(node, "maxHeight", f.maxHeight);
+        readKey(node, "minAspect", f.minAspect);
+        readKey(node, "maxAspect", f.maxAspect);
+        readKey(node, "minArea", f.minArea);
+        loaded.push_back(z);
+    }
+    if (loaded.empty()) return false;
+
+    zones = loaded;
+    configured = true;
+    std::cout << "🗺️  Zonas cargadas de " << path << ": " << zones.size() << std::endl;
+    return true;
+}
+
+std::vector<cv::Point> ZoneSet::toPixels(const DetectionZone& z, cv::Size size) const {
+    std::vector<cv::Point> pts;
+    for (const auto& p : z.polygon) pts.push_back(cv::Point(cvRound(p.x * size.width), cvRound(p.y * size.height)));
+    return pts;
+}
+
+int ZoneSet::zoneAt(cv::Point2f p, cv::Size size) const {
+    cv::Point2f n(p.x / size.width, p.y / size.height);
+    for (size_t i = 0; i < zones.size(); i++) {
+        if (cv::pointPolygonTest(zones[i].polygon, n, false) >= 0) return (int)i;
+    }
+    return -1;
+}
+
+static long long windowsIn(cv::Size img, cv::Size win, cv::Size stride) {
+    if (img.width < win.width || img.height < win.height) return 0;
+    return (long long)((img.width - win.width) / stride.width + 1) * ((img.height - win.height) / stride.height + 1);
+}
+
+// Un nivel de la pirámide de una zona: se ejecutan todos en paralelo
+struct ZoneLevelTask {
+    int zone;
+    double scale;
+    cv::Rect bounds;
+    std::vector<cv::Rect> found;
+    std::vector<double> weights;
+    long long pixels = 0, windows = 0;
+};
+
+void ZoneSet::detect(const cv::Mat& img, const cv::HOGDescriptor& hog, cv::Size winStride, double scale0,
+                     std::vector<cv::Rect>& found, std::vector<double>& weights, std::vector<int>& zoneOf) {
+    found.clear();
+    weights.clear();
+    zoneOf.clear();
+    stats = ZoneScanStats();
+
+    const cv::Size win = hog.winSize;
+    const cv::Rect frameRect(0, 0, img.cols, img.rows);
+
+    // Referencia: la pirámide completa que recorrería detectMultiScale
+    for (double s = 1.0; img.cols / s >= win.width && img.rows / s >= win.height; s *= scale0) {
+        cv::Size sz(cvRound(img.cols / s), cvRound(img.rows / s));
+        stats.fullPixels += sz.area();
+        stats.fullWindows += windowsIn(sz, win, winStride);
+        if (scale0 <= 1.0) break;
+    }
+
+    // Sin zonas configuradas: exactamente el barrido de siempre
+    if (!configured) {
+        hog.detectMultiScale(img, found, weights, zones[0].filter.hitThreshold, winStride,
+                             cv::Size(HOG_PADDING, HOG_PADDING), scale0, 2);
+        zoneOf.assign(found.size(), 0);
+        stats.pixels = stats.fullPixels;
+        stats.windows = stats.fullWindows;
+        return;
+    }
+
+    std::vector<ZoneLevelTask> tasks;
+    for (size_t zi = 0; zi < zones.size(); zi++) {
+        const DetectionZone& z = zones[zi];
+        cv::Rect bounds = cv::boundingRect(toPixels(z, img.size())) & frameRect;
+        if (bounds.area() == 0) continue;
+
+        // Alturas de caja admitidas; se tolera un paso de escala porque el agrupado promedia niveles
+        double minBoxH = z.filter.minHeight * img.rows / scale0;
+        double maxBoxH = z.filter.maxHeight * img.rows * scale0;
+        for (double s = 1.0; ; s *= scale0) {
+            double boxH = win.height * s;
+            if (win.width * s > img.cols || boxH > img.rows || boxH > maxBoxH) break;
+            if (boxH >= minBoxH) {
+                ZoneLevelTask t;
+                t.zone = (int)zi;
+                t.scale = s;
+                t.bounds = bounds;
+                tasks.push_back(t);
+            }
+            if (scale0 <= 1.0) break;
+        }
+    }
+
+    cv::parallel_for_(cv::Range(0, (int)tasks.size()), [&](const cv::Range& range) {
+        cv::Mat level;
+        std::vector<cv::Point> hits;
+        std::vector<double> hitWeights;
+        for (int ti = range.start; ti < range.end; ti++) {
+            ZoneLevelTask& t = tasks[ti];
+            const double s = t.scale;
+            const double boxW = win.width * s, boxH = win.height * s;
+
+            // Ventanas cuyo centro cae dentro del rectángulo envolvente de la zona; en los bordes
+            // del frame se permite salir hasta HOG_PADDING, como hacía detectMultiScale
+            const double pad = HOG_PADDING * s;
+            cv::Rect wanted(cvFloor(t.bounds.x - boxW / 2), cvFloor(t.bounds.y - boxH / 2),
+                            cvCeil(t.bounds.width + boxW), cvCeil(t.bounds.height + boxH));
+            wanted &= cv::Rect(cvFloor(-pad), cvFloor(-pad), cvCeil(img.cols + 2 * pad), cvCeil(img.rows + 2 * pad));
+            cv::Rect inside = wanted & frameRect;
+            cv::Size sz(cvRound(inside.width / s), cvRound(inside.height / s));
+            if (sz.width <= 0 || sz.height <= 0) continue;
+
+            cv::resize(img(inside), level, sz, 0, 0, cv::INTER_LINEAR);
+            int left = cvRound((inside.x - wanted.x) / s), top = cvRound((inside.y - wanted.y) / s);
+            int right = cvRound((wanted.br().x - inside.br().x) / s), bottom = cvRound((wanted.br().y - inside.br().y) / s);
+            if (left > 0 || top > 0 || right > 0 || bottom > 0) {
+                cv::copyMakeBorder(level, level, top, bottom, left, right, cv::BORDER_REFLECT_101);
+            }
+            if (level.cols < win.width || level.rows < win.height) continue;
+
+            hog.detect(level, hits, hitWeights, zones[t.zone].filter.hitThreshold, winStride, cv::Size());
+            t.pixels = level.total();
+            t.windows = windowsIn(level.size(), win, winStride);
+
+            const double x0 = inside.x - left * s, y0 = inside.y - top * s;
+            for (size_t i = 0; i < hits.size(); i++) {
+                cv::Rect r(cvRound(x0 + hits[i].x * s), cvRound(y0 + hits[i].y * s), cvRound(boxW), cvRound(boxH));
+                cv::Point2f center(r.x + r.width * 0.5f, r.y + r.height * 0.5f);
+                if (zoneAt(center, img.size()) != t.zone) continue;
+                t.found.push_back(r);
+                t.weights.push_back(hitWeights[i]);
+            }
+        }
+    });
+
+    // Agrupado conjunto: una persona en el borde entre dos zonas reparte sus ventanas entre
+    // ambas y, agrupadas por separado, ninguna mitad llegaría al umbral de 2
+    std::vector<cv::Rect> hitRects;
+    std::vector<int> hitZones;
+    for (const auto& t : tasks) {
+        found.insert(found.end(), t.found.begin(), t.found.end());
+        weights.insert(weights.end(), t.weights.begin(), t.weights.end());
+        hitRects.insert(hitRects.end(), t.found.begin(), t.found.end());
+        hitZones.insert(hitZones.end(), t.found.size(), t.zone);
+        stats.pixels += t.pixels;
+        stats.windows += t.windows;
+    }
+    groupHOGRectangles(found, weights, 2);
+
+    // La zona sale del centro de la caja agrupada; si el promedio cae fuera de todas,
+    // la de la ventana original más cercana
+    zoneOf.resize(found.size());
+    for (size_t i = 0; i < found.size(); i++) {
+        cv::Point2f center(found[i].x + found[i].width * 0.5f, found[i].y + found[i].height * 0.5f);
+        zoneOf[i] = zoneAt(center, img.size());
+        if (zoneOf[i] >= 0) continue;
+        double best = DBL_MAX;
+        for (size_t k = 0; k < hitRects.size(); k++) {
+            cv::Point2f c(hitRects[k].x + hitRects[k].width * 0.5f, hitRects[k].y + hitRects[k].height * 0.5f);
+            double d = cv::norm(c - center);
+            if (d < best) {
+                best = d;
+                zoneOf[i] = hitZones[k];
+            }
+        }
+    }
+}
+
+void ZoneSet::draw(cv::Mat& frame) const {
+    for (const auto& z : zones) {
+        std::vector<std::vector<cv::Point>> poly = {toPixels(z, frame.size())};
+        cv::polylines(frame, poly, true, cv::Scalar(255, 200, 0), 1);
+        cv::putText(frame, z.name, poly[0][0] + cv::Point(4, 14), cv::FONT_HERSHEY_SIMPLEX, 0.4,
+                    cv::Scalar(255, 200, 0), 1);
+    }
+}
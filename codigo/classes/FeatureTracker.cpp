@@ -0,0 +1,172 @@
+/**
+ * codigo/classes/FeatureTracker.cpp
+ * Seguimiento incremental de puntos clave (KLT / FAST+ORB) y estimación de movimiento global.
+ */
+
+#include "../cabezeras/FeatureTracker.h"
+#include <algorithm>
+
+// --- CONFIGURACIÓN ---
+const int GRID_COLS = 4;                    // Rejilla para redistribuir puntos perdidos
+const int GRID_ROWS = 4;
+const int FAST_THRESHOLD = 20;
+const double RANSAC_REPROJ_PX = 1.5;        // Tolerancia para considerar un punto "de fondo"
+const float STATIC_MOTION_PX = 0.5f;        // Traslación máxima para considerar la cámara quieta
+const double STATIC_MOVING_FRACTION = 0.05; // Puntos con movimiento propio tolerados
+const double STATIC_LOST_FRACTION = 0.15;   // Puntos perdidos tolerados (oclusiones)
+const int STATIC_MIN_FRAMES = 5;            // Frames seguidos para declarar la escena estática
+
+FeatureTracker::FeatureTracker(FeatureMode _mode, int _maxPoints)
+    : mode(_mode), maxPoints(_maxPoints), globalMotion(0, 0), movingFraction(1.0),
+      lostFraction(1.0), motionValid(false), staticFrames(0), framesSinceReference(0) {
+    // FAST como detector y ORB como descriptor; pocas octavas porque solo interesa el movimiento
+    orb = cv::ORB::create(maxPoints, 1.2f, 4, 31, 0, 2, cv::ORB::FAST_SCORE, 31, FAST_THRESHOLD);
+}
+
+void FeatureTracker::setMode(FeatureMode _mode) {
+    mode = _mode;
+    prevGray.release();
+    points.clear();
+    prevKeypoints.clear();
+    prevDescriptors.release();
+    globalMotion = cv::Point2f(0, 0);
+    motionValid = false;
+    staticFrames = 0;
+    framesSinceReference = 0;
+}
+
+void FeatureTracker::process(const cv::Mat& gray, bool redetect) {
+    if (mode == FeatureMode::OFF) return;
+
+    bool wasValid = motionValid;
+    motionValid = false;
+    // KLT compara con el frame anterior (1); ORB con la última re-detección (featureEvery)
+    int gap = ++framesSinceReference;
+
+    if (mode == FeatureMode::KLT) trackKLT(gray, redetect);
+    else trackORB(gray, redetect);
+
+    if (!motionValid) {
+        // En modo ORB no se mide nada entre re-detecciones: conservar el estado anterior
+        if (mode == FeatureMode::ORB && !redetect) motionValid = wasValid;
+        else staticFrames = 0;
+        return;
+    }
+
+    // La medición abarca gap frames: se normaliza a px/frame y cuenta como gap frames estáticos
+    if (gap > 1) globalMotion /= (float)gap;
+    bool staticNow = cv::norm(globalMotion) < STATIC_MOTION_PX &&
+                     movingFraction < STATIC_MOVING_FRACTION &&
+                     lostFraction < STATIC_LOST_FRACTION;
+    staticFrames = staticNow ? staticFrames + gap : 0;
+}
+
+bool FeatureTracker::isStatic() const {
+    return mode != FeatureMode::OFF && staticFrames >= STATIC_MIN_FRAMES;
+}
+
+void FeatureTracker::trackKLT(const cv::Mat& gray, bool redetect) {
+    if (prevGray.empty() || points.empty()) {
+        points.clear();
+        redetectLostRegions(gray);
+        gray.copyTo(prevGray);
+        framesSinceReference = 0;
+        return;
+    }
+
+    std::vector<cv::Point2f> next;
+    std::vector<uchar> status;
+    std::vector<float> err;
+    cv::calcOpticalFlowPyrLK(prevGray, gray, points, next, status, err, cv::Size(15, 15), 2);
+
+    cv::Rect bounds(0, 0, gray.cols, gray.rows);
+    std::vector<cv::Point2f> from, to;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (!status[i] || !bounds.contains(cv::Point(cvRound(next[i].x), cvRound(next[i].y)))) continue;
+        from.push_back(points[i]);
+        to.push_back(next[i]);
+    }
+
+    lostFraction = 1.0 - (double)to.size() / (double)points.size();
+    estimateMotion(from, to);
+    points = to;
+
+    // Solo se vuelve a detectar en la cadencia pedida o si se perdió demasiado
+    if (redetect || (int)points.size() < maxPoints / 2) redetectLostRegions(gray);
+
+    gray.copyTo(prevGray);
+    framesSinceReference = 0;
+}
+
+void FeatureTracker::trackORB(const cv::Mat& gray, bool redetect) {
+    if (!redetect && !prevDescriptors.empty()) return;
+
+    std::vector<cv::KeyPoint> keypoints;
+    cv::Mat descriptors;
+    orb->detectAndCompute(gray, cv::noArray(), keypoints, descriptors);
+
+    if (!prevDescriptors.empty() && !descriptors.empty()) {
+        std::vector<cv::DMatch> matches;
+        cv::BFMatcher matcher(cv::NORM_HAMMING, true);
+        matcher.match(prevDescriptors, descriptors, matches);
+
+        std::vector<cv::Point2f> from, to;
+        for (const auto& m : matches) {
+            if (m.distance > 64) continue;
+            from.push_back(prevKeypoints[m.queryIdx].pt);
+            to.push_back(keypoints[m.trainIdx].pt);
+        }
+        // FAST re-detecta cada vez: un punto sin pareja no implica una región perdida
+        lostFraction = 0.0;
+        estimateMotion(from, to);
+    }
+
+    prevKeypoints = keypoints;
+    prevDescriptors = descriptors;
+    framesSinceReference = 0;
+    cv::KeyPoint::convert(keypoints, points);
+}
+
+void FeatureTracker::redetectLostRegions(const cv::Mat& gray) {
+    int cellW = gray.cols / GRID_COLS;
+    int cellH = gray.rows / GRID_ROWS;
+    if (cellW <= 0 || cellH <= 0) return;
+
+    int perCell = std::max(1, maxPoints / (GRID_COLS * GRID_ROWS));
+    std::vector<int> occupancy(GRID_COLS * GRID_ROWS, 0);
+    for (const auto& p : points) {
+        int cx = std::min(GRID_COLS - 1, (int)p.x / cellW);
+        int cy = std::min(GRID_ROWS - 1, (int)p.y / cellH);
+        occupancy[cy * GRID_COLS + cx]++;
+    }
+
+    for (int cy = 0; cy < GRID_ROWS; cy++) {
+        for (int cx = 0; cx < GRID_COLS; cx++) {
+            int missing = perCell - occupancy[cy * GRID_COLS + cx];
+            // Celdas que conservan al menos la mitad de sus puntos no se tocan
+            if (missing * 2 < perCell) continue;
+
+            cv::Rect cell(cx * cellW, cy * cellH, cellW, cellH);
+            std::vector<cv::KeyPoint> found;
+            cv::FAST(gray(cell), found, FAST_THRESHOLD, true);
+            cv::KeyPointsFilter::retainBest(found, missing);
+
+            for (const auto& kp : found) {
+                points.push_back(kp.pt + cv::Point2f((float)cell.x, (float)cell.y));
+            }
+        }
+    }
+}
+
+void FeatureTracker::estimateMotion(const std::vector<cv::Point2f>& from, const std::vector<cv::Point2f>& to) {
+    if (from.size() < 8) return;
+
+    std::vector<uchar> inliers;
+    cv::Mat affine = cv::estimateAffinePartial2D(from, to, inliers, cv::RANSAC, RANSAC_REPROJ_PX);
+    if (affine.empty()) return;
+
+    globalMotion = cv::Point2f((float)affine.at<double>(0, 2), (float)affine.at<double>(1, 2));
+    long outliers = std::count(inliers.begin(), inliers.end(), (uchar)0);
+    movingFraction = (double)outliers / (double)from.size();
+    motionValid = true;
+}
@@ -0,0 +1,183 @@
+/**
+ * codigo/classes/HOGKernel.cpp
+ * Selección de la especialización HOG según la geometría del modelo cargado.
+ */
+
+#include "../cabezeras/HOGKernel.h"
+#include <filesystem>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+
+// Instancias para nuestras geometrías (el resto del código solo ve HOGScorer)
+template class HOGKernel<HOGGeom64x128>;
+template class HOGKernel<HOGGeom64x64>;
+
+std::unique_ptr<HOGScorer> createHOGScorer(cv::Size winSize, const std::vector<float>& detector, bool gammaCorrection) {
+    std::unique_ptr<HOGScorer> scorer;
+    if (winSize == cv::Size(HOGGeom64x128::winW, HOGGeom64x128::winH)) {
+        scorer.reset(new HOGKernel<HOGGeom64x128>(detector, gammaCorrection));
+    } else if (winSize == cv::Size(HOGGeom64x64::winW, HOGGeom64x64::winH)) {
+        scorer.reset(new HOGKernel<HOGGeom64x64>(detector, gammaCorrection));
+    } else {
+        return nullptr;
+    }
+
+    // Un detector con otra dimensión no sirve para esta geometría
+    if (!detector.empty() && (int)detector.size() != scorer->descriptorSize() + 1) return nullptr;
+    return scorer;
+}
+
+std::vector<float> loadHOGDetector(const std::string& path) {
+    std::vector<float> detector;
+    std::string ext = std::filesystem::path(path).extension().string();
+    if (ext == ".yml" || ext == ".yaml" || ext == ".xml") {
+        cv::FileStorage fsIn(path, cv::FileStorage::READ);
+        if (fsIn.isOpened()) fsIn["detector"] >> detector;
+        return detector;
+    }
+    std::ifstream file(path);
+    float value;
+    while (file >> value) detector.push_back(value);
+    return detector;
+}
+
+cv::Size hogWinSizeFor(size_t detectorSize) {
+    if ((int)detectorSize == HOGGeom64x128::descriptorSize + 1) return cv::Size(HOGGeom64x128::winW, HOGGeom64x128::winH);
+    if ((int)detectorSize == HOGGeom64x64::descriptorSize + 1) return cv::Size(HOGGeom64x64::winW, HOGGeom64x64::winH);
+    return cv::Size();
+}
+
+// --- SVM CUANTIZADO ---
+
+QuantizedSVM quantizeSVM(const std::vector<float>& detector) {
+    QuantizedSVM q;
+    q.scale = 0.f;
+    q.bias = detector.empty() ? 0.f : detector.back();
+    q.sourceSize = (int)detector.size();
+    q.sourceBias = q.bias;
+    q.sourceHash = detectorHash(detector);
+    if (detector.size() < 2) return q;
+
+    // Escala simétrica por modelo: el peso de mayor magnitud ocupa todo el rango int8
+    float maxAbs = 0.f;
+    for (size_t i = 0; i + 1 < detector.size(); i++) maxAbs = std::max(maxAbs, std::abs(detector[i]));
+    q.scale = maxAbs > 0.f ? maxAbs / 127.f : 1.f;
+
+    q.weights.resize(detector.size() - 1);
+    for (size_t i = 0; i < q.weights.size(); i++) {
+        q.weights[i] = cv::saturate_cast<schar>(detector[i] / q.scale);
+    }
+    return q;
+}
+
+uint32_t detectorHash(const std::vector<float>& detector) {
+    uint32_t hash = 2166136261u;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(detector.data());
+    for (size_t i = 0; i < detector.size() * sizeof(float); i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool quantizedFrom(const QuantizedSVM& q, const std::vector<float>& detector) {
+    return q.sourceSize == (int)detector.size() && !detector.empty() && q.sourceBias == detector.back() &&
+           q.sourceHash == detectorHash(detector);
+}
+
+double quantizedScore(const QuantizedSVM& q, const std::vector<float>& descriptor) {
+    CV_Assert(descriptor.size() == q.weights.size());
+    long long acc = 0;
+    for (size_t i = 0; i < descriptor.size(); i++) {
+        acc += (int)quantizeFeature(descriptor[i]) * (int)q.weights[i];
+    }
+    return q.bias + acc * (q.scale / 255.0);
+}
+
+bool saveQuantizedSVM(const std::string& path, const QuantizedSVM& q, cv::Size winSize) {
+    cv::FileStorage fs(path, cv::FileStorage::WRITE);
+    if (!fs.isOpened()) return false;
+    fs << "winWidth" << winSize.width;
+    fs << "winHeight" << winSize.height;
+    fs << "scale" << q.scale;
+    fs << "bias" << q.bias;
+    fs << "weights" << cv::Mat(1, (int)q.weights.size(), CV_8S, (void*)q.weights.data());
+    fs << "sourceSize" << q.sourceSize;
+    fs << "sourceBias" << q.sourceBias;
+    fs << "sourceHash" << cv::format("%08x", q.sourceHash); // Texto: FileStorage solo guarda int con signo
+    return true;
+}
+
+bool loadQuantizedSVM(const std::string& path, QuantizedSVM& q, cv::Size& winSize) {
+    cv::FileStorage fs(path, cv::FileStorage::READ);
+    if (!fs.isOpened()) return false;
+
+    cv::Mat w;
+    fs["weights"] >> w;
+    if (w.empty() || w.type() != CV_8S) return false;
+
+    winSize = cv::Size((int)fs["winWidth"], (int)fs["winHeight"]);
+    q.scale = (float)fs["scale"];
+    q.bias = (float)fs["bias"];
+    q.weights.assign(w.ptr<schar>(), w.ptr<schar>() + w.total());
+
+    // Archivos anteriores a la huella: sourceSize 0 nunca coincide con un detector
+    q.sourceSize = fs["sourceSize"].empty() ? 0 : (int)fs["sourceSize"];
+    q.sourceBias = (float)fs["sourceBias"];
+    std::string hash = fs["sourceHash"].empty() ? std::string() : (std::string)fs["sourceHash"];
+    q.sourceHash = (uint32_t)std::strtoul(hash.c_str(), nullptr, 16);
+    return true;
+}
+
+void groupHOGRectangles(std::vector<cv::Rect>& rects, std::vector<double>& weights, int groupThreshold, double eps) {
+    if (groupThreshold <= 0 || rects.empty()) return;
+
+    std::vector<int> labels;
+    int nclasses = cv::partition(rects, labels, cv::SimilarRects(eps));
+
+    std::vector<cv::Rect_<double>> avg(nclasses);
+    std::vector<int> numInClass(nclasses, 0);
+    std::vector<double> maxWeight(nclasses, -std::numeric_limits<double>::max());
+    for (size_t i = 0; i < labels.size(); i++) {
+        int cls = labels[i];
+        avg[cls].x += rects[i].x;
+        avg[cls].y += rects[i].y;
+        avg[cls].width += rects[i].width;
+        avg[cls].height += rects[i].height;
+        maxWeight[cls] = std::max(maxWeight[cls], weights[i]);
+        numInClass[cls]++;
+    }
+
+    std::vector<cv::Rect> clusters(nclasses);
+    for (int i = 0; i < nclasses; i++) {
+        double s = 1.0 / numInClass[i];
+        clusters[i] = cv::Rect(cvRound(avg[i].x * s), cvRound(avg[i].y * s),
+                               cvRound(avg[i].width * s), cvRound(avg[i].height * s));
+    }
+
+    rects.clear();
+    weights.clear();
+    for (int i = 0; i < nclasses; i++) {
+        const cv::Rect& r1 = clusters[i];
+        int n1 = numInClass[i];
+        if (n1 <= groupThreshold) continue;
+
+        // Descartar cajas pequeñas contenidas en otra con más votos
+        int j = 0;
+        for (; j < nclasses; j++) {
+            int n2 = numInClass[j];
+            if (j == i || n2 <= groupThreshold) continue;
+            const cv::Rect& r2 = clusters[j];
+            int dx = cv::saturate_cast<int>(r2.width * eps);
+            int dy = cv::saturate_cast<int>(r2.height * eps);
+            if (r1.x >= r2.x - dx && r1.y >= r2.y - dy &&
+                r1.x + r1.width <= r2.x + r2.width + dx &&
+                r1.y + r1.height <= r2.y + r2.height + dy &&
+                (n2 > std::max(3, n1) || n1 < 3)) break;
+        }
+        if (j == nclasses) {
+            rects.push_back(r1);
+            weights.push_back(maxWeight[i]);
+        }
+    }
+}
@@ -0,0 +1,211 @@
+/**
+ * codigo/classes/LightingCorrection.cpp
+ * Análisis de condiciones de luz y corrección adaptativa (CLAHE + gamma).
+ */
+
+#include "../cabezeras/LightingCorrection.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// --- CONFIGURACIÓN (umbrales de cada condición) ---
+const double BACKLIT_EDGE_DIFF = 50, BACKLIT_BRIGHT = 0.25;
+const double OVEREXPOSED_MEAN = 200, OVEREXPOSED_BRIGHT = 0.4;
+const double UNDEREXPOSED_MEAN = 60, UNDEREXPOSED_DARK = 0.5;
+// Histéresis: para salir del modo actual la condición debe fallar por este margen
+const double HYST_DIFF = 10, HYST_FRACTION = 0.05, HYST_MEAN = 10;
+
+LightingAnalysis analyzeLighting(const cv::Mat& gray) {
+    LightingAnalysis result;
+
+    // Calcular estadísticas básicas
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(gray, mean, stddev);
+    result.meanBrightness = mean[0];
+    result.stdDevBrightness = stddev[0];
+
+    // Calcular histograma
+    cv::Mat hist;
+    int histSize = 256;
+    float range[] = {0, 256};
+    const float* histRange = {range};
+    cv::calcHist(&gray, 1, 0, cv::Mat(), hist, 1, &histSize, &histRange);
+
+    // Normalizar histograma
+    cv::normalize(hist, hist, 0, gray.rows * gray.cols, cv::NORM_MINMAX);
+
+    // Análisis de distribución de luminosidad
+    float darkPixels = 0, brightPixels = 0, midPixels = 0;
+    for (int i = 0; i < 85; i++) darkPixels += hist.at<float>(i);
+    for (int i = 85; i < 170; i++) midPixels += hist.at<float>(i);
+    for (int i = 170; i < 256; i++) brightPixels += hist.at<float>(i);
+
+    float totalPixels = gray.rows * gray.cols;
+
+    // Detección de contraluz (backlight)
+    // Hay mucha luminosidad en los bordes y oscuridad en el centro
+    cv::Rect centerROI(gray.cols * 0.3, gray.rows * 0.3, gray.cols * 0.4, gray.rows * 0.4);
+    cv::Rect edgeROI1(0, 0, gray.cols, gray.rows * 0.2); // Top edge
+    cv::Mat centerRegion = gray(centerROI);
+    cv::Mat edgeRegion = gray(edgeROI1);
+
+    double centerMean = cv::mean(centerRegion)[0];
+    double edgeMean = cv::mean(edgeRegion)[0];
+
+    result.edgeCenterDiff = edgeMean - centerMean;
+    result.darkFraction = darkPixels / totalPixels;
+    result.brightFraction = brightPixels / totalPixels;
+
+    result.isBacklit = (result.edgeCenterDiff > BACKLIT_EDGE_DIFF) && (result.brightFraction > BACKLIT_BRIGHT);
+
+    // Detección de sobreexposición
+    result.isOverexposed = (result.meanBrightness > OVEREXPOSED_MEAN) || (result.brightFraction > OVEREXPOSED_BRIGHT);
+
+    // Detección de subexposición
+    result.isUnderexposed = (result.meanBrightness < UNDEREXPOSED_MEAN) || (result.darkFraction > UNDEREXPOSED_DARK);
+
+    // Detección de alto contraste
+    result.hasHighContrast = result.stdDevBrightness > 60;
+
+    // Rango dinámico
+    double minVal, maxVal;
+    cv::minMaxLoc(gray, &minVal, &maxVal);
+    result.dynamicRange = maxVal - minVal;
+
+    return result;
+}
+
+LightingMode lightingMode(const LightingAnalysis& analysis) {
+    if (analysis.isBacklit) return LightingMode::BACKLIT;
+    if (analysis.isOverexposed) return LightingMode::OVEREXPOSED;
+    if (analysis.isUnderexposed) return LightingMode::UNDEREXPOSED;
+    return LightingMode::NORMAL;
+}
+
+static cv::Mat gammaLUT(double gamma) {
+    cv::Mat lookUpTable(1, 256, CV_8U);
+    uchar* p = lookUpTable.ptr();
+    for(int i = 0; i < 256; ++i) {
+        p[i] = cv::saturate_cast<uchar>(std::pow(i / 255.0, gamma) * 255.0);
+    }
+    return lookUpTable;
+}
+
+LightingCorrector::LightingCorrector(LightingMode mode) {
+    switch (mode) {
+        // Si hay contraluz, aplicar ecualización adaptativa más agresiva
+        // y corrección gamma para levantar sombras (gamma < 1)
+        case LightingMode::BACKLIT:
+            clahe = cv::createCLAHE(3.0, cv::Size(8, 8));
+            lut = gammaLUT(0.7);
+            break;
+        // Si está sobreexpuesto, reducir brillo un 20 %
+        case LightingMode::OVEREXPOSED: {
+            clahe = cv::createCLAHE(1.0, cv::Size(16, 16));
+            lut.create(1, 256, CV_8U);
+            uchar* p = lut.ptr();
+            for (int i = 0; i < 256; ++i) p[i] = cv::saturate_cast<uchar>(i * 0.8);
+            break;
+        }
+        // Si está subexpuesto, gamma para aclarar (gamma > 1)
+        case LightingMode::UNDEREXPOSED:
+            clahe = cv::createCLAHE(2.5, cv::Size(8, 8));
+            lut = gammaLUT(1.3);
+            break;
+        // Condiciones normales
+        default:
+            clahe = cv::createCLAHE(1.5, cv::Size(8, 8));
+            break;
+    }
+}
+
+void LightingCorrector::apply(const cv::Mat& input, cv::Mat& output) {
+    clahe->apply(input, output);
+    if (!lut.empty()) cv::LUT(output, lut, output);
+}
+
+cv::Mat correctLighting(const cv::Mat& input, const LightingAnalysis& analysis) {
+    LightingCorrector corrector(lightingMode(analysis));
+    cv::Mat corrected;
+    corrector.apply(input, corrected);
+    return corrected;
+}
+
+// ================= SEGUIMIENTO TEMPORAL =================
+
+static const char* modeName(LightingMode mode) {
+    switch (mode) {
+        case LightingMode::BACKLIT: return "BACKLIT";
+        case LightingMode::OVEREXPOSED: return "OVEREXP";
+        case LightingMode::UNDEREXPOSED: return "UNDEREXP";
+        default: return "OK";
+    }
+}
+
+LightingTracker::LightingTracker(int _fullEvery, int _rowStep, double _driftThreshold, int _confirmFrames)
+    : fullEvery(std::max(1, _fullEvery)), rowStep(std::max(1, _rowStep)), driftThreshold(_driftThreshold),
+      confirmFrames(std::max(1, _confirmFrames)), analysis(), mode(LightingMode::NORMAL),
+      candidate(LightingMode::NORMAL), candidateCount(0), referenceMean(0.0), meanBrightness(0.0),
+      framesSinceFull(0), analyzedThisFrame(false), fullAnalyses(0) {
+    correctors = {LightingCorrector(LightingMode::NORMAL), LightingCorrector(LightingMode::BACKLIT),
+                  LightingCorrector(LightingMode::OVEREXPOSED), LightingCorrector(LightingMode::UNDEREXPOSED)};
+}
+
+// Vista de 1 de cada rowStep filas sin copiar (mismo buffer, paso mayor)
+cv::Mat LightingTracker::subsample(const cv::Mat& gray) const {
+    if (rowStep == 1) return gray;
+    int rows = (gray.rows + rowStep - 1) / rowStep;
+    return cv::Mat(rows, gray.cols, gray.type(), const_cast<uchar*>(gray.ptr()), gray.step * rowStep);
+}
+
+// Mismas reglas que analyzeLighting, pero el modo actual se conserva hasta que su condición
+// falle con margen (evita saltar de corrección en los umbrales)
+LightingMode LightingTracker::classify(const LightingAnalysis& a) const {
+    bool inB = mode == LightingMode::BACKLIT;
+    bool inO = mode == LightingMode::OVEREXPOSED;
+    bool inU = mode == LightingMode::UNDEREXPOSED;
+
+    if (a.edgeCenterDiff > BACKLIT_EDGE_DIFF - (inB ? HYST_DIFF : 0) &&
+        a.brightFraction > BACKLIT_BRIGHT - (inB ? HYST_FRACTION : 0)) return LightingMode::BACKLIT;
+    if (a.meanBrightness > OVEREXPOSED_MEAN - (inO ? HYST_MEAN : 0) ||
+        a.brightFraction > OVEREXPOSED_BRIGHT - (inO ? HYST_FRACTION : 0)) return LightingMode::OVEREXPOSED;
+    if (a.meanBrightness < UNDEREXPOSED_MEAN + (inU ? HYST_MEAN : 0) ||
+        a.darkFraction > UNDEREXPOSED_DARK - (inU ? HYST_FRACTION : 0)) return LightingMode::UNDEREXPOSED;
+    return LightingMode::NORMAL;
+}
+
+LightingMode LightingTracker::update(const cv::Mat& gray) {
+    cv::Mat sub = subsample(gray);
+    meanBrightness = cv::mean(sub)[0];
+    framesSinceFull++;
+
+    // Con un cambio de modo pendiente se analiza cada frame hasta confirmarlo o descartarlo
+    analyzedThisFrame = fullAnalyses == 0 || framesSinceFull >= fullEvery || candidateCount > 0 ||
+                        std::abs(meanBrightness - referenceMean) > driftThreshold;
+    if (!analyzedThisFrame) return mode;
+
+    analysis = analyzeLighting(sub);
+    referenceMean = meanBrightness;
+    framesSinceFull = 0;
+    fullAnalyses++;
+
+    LightingMode observed = classify(analysis);
+    if (fullAnalyses == 1) {
+        mode = observed; // Primer frame: no hay modo previo que proteger
+    } else if (observed == mode) {
+        candidateCount = 0;
+    } else {
+        candidateCount = (observed == candidate) ? candidateCount + 1 : 1;
+        candidate = observed;
+        if (candidateCount >= confirmFrames) {
+            std::cout << "💡 Iluminación: " << modeName(mode) << " -> " << modeName(observed) << std::endl;
+            mode = observed;
+            candidateCount = 0;
+        }
+    }
+    return mode;
+}
+
+void LightingTracker::correct(const cv::Mat& input, cv::Mat& output) {
+    correctors[(int)mode].apply(input, output);
+}
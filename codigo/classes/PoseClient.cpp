@@ -0,0 +1,118 @@
+/**
+ * codigo/classes/PoseClient.cpp
+ * Envío de recortes a la API de poses (pose.py) en lote.
+ */
+
+#include "../cabezeras/PoseClient.h"
+#include <curl/curl.h>
+#include <iostream>
+#include <sstream>
+
+static size_t collect_callback(void *ptr, size_t size, size_t nmemb, void *userdata) {
+    std::string* out = static_cast<std::string*>(userdata);
+    out->append(static_cast<const char*>(ptr), size * nmemb);
+    return size * nmemb;
+}
+
+PoseClient::PoseClient(std::string _baseUrl, long _timeoutSec)
+    : baseUrl(_baseUrl), timeoutSec(_timeoutSec) {}
+
+std::vector<uchar> PoseClient::encodeCrop(const cv::Mat& crop) {
+    std::vector<uchar> buf;
+    cv::imencode(".jpg", crop, buf, {cv::IMWRITE_JPEG_QUALITY, 85});
+    return buf;
+}
+
+bool PoseClient::sendBatch(const std::vector<PoseCrop>& crops, std::vector<PoseResult>& results) {
+    results.clear();
+    if (crops.empty()) return true;
+
+    CURL *curl = curl_easy_init();
+    if (!curl) return false;
+
+    // Metadatos de cada caja, en el mismo orden que las partes "files"
+    std::ostringstream meta;
+    meta << "{\"boxes\": [";
+    for (size_t i = 0; i < crops.size(); i++) {
+        const cv::Rect& b = crops[i].box;
+        meta << (i ? ", " : "") << "{\"x\": " << b.x << ", \"y\": " << b.y
+             << ", \"w\": " << b.width << ", \"h\": " << b.height
+             << ", \"conf\": " << crops[i].confidence
+             << ", \"ts\": " << crops[i].timestampMs << "}";
+    }
+    meta << "]}";
+    std::string metaStr = meta.str();
+
+    // curl_mime_data copia los datos, así que los buffers pueden ser temporales
+    curl_mime *form = curl_mime_init(curl);
+    for (size_t i = 0; i < crops.size(); i++) {
+        std::vector<uchar> buf = crops[i].jpeg.empty() ? encodeCrop(crops[i].image) : crops[i].jpeg;
+        std::string name = "crop_" + std::to_string(i) + ".jpg";
+        curl_mimepart *field = curl_mime_addpart(form);
+        curl_mime_name(field, "files");
+        curl_mime_data(field, (const char*)buf.data(), buf.size());
+        curl_mime_filename(field, name.c_str());
+        curl_mime_type(field, "image/jpeg");
+    }
+    curl_mimepart *metaField = curl_mime_addpart(form);
+    curl_mime_name(metaField, "meta");
+    curl_mime_data(metaField, metaStr.c_str(), CURL_ZERO_TERMINATED);
+
+    std::string url = baseUrl + "/detect_batch";
+    std::string response;
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_MIMEPOST, form);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeoutSec);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, collect_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    CURLcode res = curl_easy_perform(curl);
+    curl_mime_free(form);
+    curl_easy_cleanup(curl);
+
+    if (res != CURLE_OK || response.empty()) return false;
+
+    // Respuesta: {"status": "ok", "results": [{"index": 0, "detected": 1, "keypoints": 12}, ...]}
+    try {
+        cv::FileStorage fs(response, cv::FileStorage::READ | cv::FileStorage::MEMORY | cv::FileStorage::FORMAT_JSON);
+        cv::FileNode list = fs["results"];
+        if (list.type() != cv::FileNode::SEQ) return false;
+        for (cv::FileNodeIterator it = list.begin(); it != list.end(); ++it) {
+            cv::FileNode n = *it;
+            PoseResult r;
+            r.index = (int)n["index"];
+            r.detected = (int)n["detected"] != 0;
+            r.keypoints = (int)n["keypoints"];
+            results.push_back(r);
+        }
+    } catch (const cv::Exception& e) {
+        std::cerr << "⚠️  Respuesta de lote inválida: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// --- LOTES POR VENTANA DE TIEMPO ---
+
+PoseBatcher::PoseBatcher(int _windowMs, size_t _maxCrops)
+    : windowMs(_windowMs), maxCrops(_maxCrops) {}
+
+void PoseBatcher::add(const cv::Mat& crop, cv::Rect box, double confidence) {
+    if (pending.empty()) firstAdded = std::chrono::steady_clock::now();
+    long long now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    pending.push_back({crop.clone(), {}, box, confidence, now});
+}
+
+bool PoseBatcher::due() const {
+    if (pending.empty()) return false;
+    if (pending.size() >= maxCrops) return true;
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - firstAdded).count();
+    return waited >= windowMs;
+}
+
+std::vector<PoseCrop> PoseBatcher::take() {
+    std::vector<PoseCrop> batch;
+    batch.swap(pending);
+    return batch;
+}
@@ -0,0 +1,531 @@
+/**
+ * codigo/classes/bench_pipeline.cpp
+ * Suite de rendimiento reproducible: microbenchmarks de cada etapa, frames completos sobre
+ * escenas sintéticas (y clips opcionales) y comparación contra una línea base guardada.
+ *
+ * Uso: ./bench_pipeline [--baseline bench_baseline.yml] [--save-baseline] [--max-slowdown 1.25]
+ *                       [--clips dir] [--filter texto] [--threads N]
+ * Código de salida: 0 OK | 1 regresión respecto a la línea base | 2 el kernel HOG no coincide con OpenCV
+ */
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <functional>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include "../cabezeras/LightingCorrection.h"
+#include "../cabezeras/DetectionFilters.h"
+#include "../cabezeras/DetectionZones.h"
+#include "../cabezeras/FeatureTracker.h"
+#include "../cabezeras/ComputeGovernor.h"
+#include "../cabezeras/HOGKernel.h"
+#include "../cabezeras/PoseClient.h"
+
+using namespace cv;
+using namespace std;
+namespace fs = std::filesystem;
+
+// --- CONFIGURACIÓN ---
+const string DEFAULT_BASELINE = "bench_baseline.yml";
+const double DEFAULT_MAX_SLOWDOWN = 1.25;  // Falla si la mediana empeora más de un 25 %
+const Size FRAME_SIZE(640, 480);           // Misma resolución que la cámara
+const int SEQUENCE_FRAMES = 30;            // Frames por secuencia sintética
+const int CLIP_MAX_FRAMES = 60;
+const double MIN_SAMPLE_MS = 2.0;          // Cada muestra repite la función hasta durar esto
+const double BENCH_BUDGET_MS = 1000.0;     // Tiempo aproximado por benchmark
+const int MIN_SAMPLES = 5;
+const int MAX_SAMPLES = 200;
+const float PARITY_TOLERANCE = 0.f;         // Bit a bit (ver checkHOGParity)
+const uint64 SCENE_SEED = 0x5EED;          // Misma escena en todas las máquinas
+
+// ================= ARNÉS =================
+
+static volatile double sink = 0; // Evita que el compilador elimine el trabajo medido
+
+struct BenchResult {
+    string name;
+    double medianUs;
+    double minUs;
+    int samples;
+    long long iterations;
+};
+
+double elapsedUs(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+}
+
+BenchResult runBench(const string& name, const function<double()>& fn) {
+    // Calibrar repeticiones por muestra para que el reloj no domine en funciones rápidas
+    long long iters = 1;
+    while (true) {
+        auto t0 = chrono::steady_clock::now();
+        for (long long i = 0; i < iters; i++) sink = sink + fn();
+        if (elapsedUs(t0) >= MIN_SAMPLE_MS * 1000.0 || iters >= (1LL << 24)) break;
+        iters *= 2;
+    }
+
+    vector<double> samples;
+    auto start = chrono::steady_clock::now();
+    while ((int)samples.size() < MIN_SAMPLES ||
+           (elapsedUs(start) < BENCH_BUDGET_MS * 1000.0 && (int)samples.size() < MAX_SAMPLES)) {
+        auto t0 = chrono::steady_clock::now();
+        for (long long i = 0; i < iters; i++) sink = sink + fn();
+        samples.push_back(elapsedUs(t0) / iters);
+    }
+
+    sort(samples.begin(), samples.end());
+    BenchResult r;
+    r.name = name;
+    r.medianUs = samples[samples.size() / 2];
+    r.minUs = samples.front();
+    r.samples = (int)samples.size();
+    r.iterations = iters * (long long)samples.size();
+    return r;
+}
+
+// ================= ESCENAS SINTÉTICAS =================
+
+enum class SceneLight { NORMAL, DARK, BACKLIT, OVEREXPOSED };
+
+const vector<pair<SceneLight, string>> SCENE_LIGHTS = {
+    {SceneLight::NORMAL, "normal"},
+    {SceneLight::DARK, "dark"},
+    {SceneLight::BACKLIT, "backlit"},
+    {SceneLight::OVEREXPOSED, "overexposed"},
+};
+
+// Silueta simple (cabeza, torso, brazos, piernas) con las proporciones de una persona de pie
+void drawPerson(Mat& img, Rect box, Scalar color) {
+    int cx = box.x + box.width / 2;
+    int head = box.height / 8;
+    circle(img, Point(cx, box.y + head), head, color, FILLED, LINE_AA);
+    Rect torso(cx - box.width / 4, box.y + 2 * head, box.width / 2, box.height * 3 / 8);
+    rectangle(img, torso, color, FILLED);
+    int limb = max(2, box.width / 8);
+    Point hip(cx, torso.br().y);
+    line(img, Point(torso.x, torso.y + limb), Point(box.x, hip.y), color, limb, LINE_AA);
+    line(img, Point(torso.br().x, torso.y + limb), Point(box.br().x, hip.y), color, limb, LINE_AA);
+    line(img, hip, Point(cx - box.width / 4, box.br().y), color, limb + 1, LINE_AA);
+    line(img, hip, Point(cx + box.width / 4, box.br().y), color, limb + 1, LINE_AA);
+}
+
+// Frame t de una escena de pasillo: fondo fijo, tres personas que avanzan y ruido de sensor
+Mat makeScene(SceneLight light, int t) {
+    Mat img(FRAME_SIZE, CV_8UC3);
+    for (int y = 0; y < img.rows; y++) {
+        int v = 90 + 60 * y / img.rows;
+        img.row(y).setTo(Scalar(v, v + 10, v - 10));
+    }
+
+    RNG rng(SCENE_SEED);
+    for (int k = 0; k < 6; k++) {
+        Rect panel(rng.uniform(0, img.cols - 80), rng.uniform(0, img.rows / 2), rng.uniform(40, 160), rng.uniform(60, 200));
+        int g = rng.uniform(60, 200);
+        rectangle(img, panel & Rect(Point(), img.size()), Scalar(g, g, g + 15), FILLED);
+    }
+
+    for (int p = 0; p < 3; p++) {
+        int h = 140 + p * 60;
+        int w = cvRound(h / 2.6);
+        int x = (80 + p * 190 + t * (3 + p)) % (img.cols - w);
+        drawPerson(img, Rect(x, img.rows - 10 - h, w, h), Scalar(40 + 30 * p, 35, 60));
+    }
+
+    switch (light) {
+        case SceneLight::DARK:
+            img *= 0.3;
+            break;
+        case SceneLight::OVEREXPOSED:
+            img.convertTo(img, -1, 0.6, 140);
+            break;
+        case SceneLight::BACKLIT: {
+            // Ventanal brillante arriba, sujetos en sombra
+            img *= 0.5;
+            img(Rect(0, 0, img.cols, img.rows * 3 / 10)).setTo(Scalar(245, 245, 245));
+            break;
+        }
+        default:
+            break;
+    }
+
+    Mat noise(img.size(), CV_16SC3), wide;
+    RNG noiseRng(SCENE_SEED + t);
+    noiseRng.fill(noise, RNG::NORMAL, 0, 6);
+    img.convertTo(wide, CV_16SC3);
+    wide += noise;
+    wide.convertTo(img, CV_8UC3);
+    return img;
+}
+
+vector<Mat> makeSequence(SceneLight light) {
+    vector<Mat> frames;
+    for (int t = 0; t < SEQUENCE_FRAMES; t++) frames.push_back(makeScene(light, t));
+    return frames;
+}
+
+vector<Mat> loadClip(const string& path) {
+    vector<Mat> frames;
+    VideoCapture cap(path);
+    Mat frame;
+    while ((int)frames.size() < CLIP_MAX_FRAMES && cap.read(frame)) {
+        Mat resized;
+        resize(frame, resized, FRAME_SIZE);
+        frames.push_back(resized);
+    }
+    return frames;
+}
+
+// ================= FRAME COMPLETO =================
+// Mismas etapas que el bucle de detect_pedestrians con las perillas de calidad máxima
+
+struct Pipeline {
+    HOGDescriptor hog;
+    FeatureTracker tracker;
+    LightingTracker lighting;
+    ZoneSet zones;
+    DetectionKnobs knobs;
+    int frameCounter = 0;
+
+    Mat gray, blurred, corrected;
+    vector<Rect> found, validBoxes;
+    vector<double> weights, validWeights;
+    vector<int> zoneOf;
+
+    Pipeline() : tracker(FeatureMode::KLT, 100), knobs(ComputeGovernor(0, 0).knobs()) {
+        hog.setSVMDetector(HOGDescriptor::getDefaultPeopleDetector());
+    }
+
+    size_t process(const Mat& frame) {
+        cvtColor(frame, gray, COLOR_BGR2GRAY);
+        lighting.update(gray);
+        GaussianBlur(gray, blurred, Size(5, 5), 0);
+        lighting.correct(blurred, corrected);
+        tracker.process(blurred, frameCounter % knobs.featureEvery == 0);
+
+        zones.detect(corrected, hog, Size(knobs.winStride, knobs.winStride), knobs.hogScale, found, weights, zoneOf);
+        validBoxes.clear();
+        validWeights.clear();
+        for (size_t i = 0; i < found.size(); i++) {
+            if (isValidDetection(found[i], weights[i], frame.cols, frame.rows, zones.zone(zoneOf[i]).filter)) {
+                validBoxes.push_back(found[i]);
+                validWeights.push_back(weights[i]);
+            }
+        }
+        frameCounter++;
+        return improvedNMS(validBoxes, validWeights, 0.3).size();
+    }
+};
+
+// ================= PARIDAD DEL KERNEL HOG =================
+// El kernel especializado debe dar el mismo descriptor que HOGDescriptor::compute, bit a bit:
+// repite los mismos productos y sumas en el mismo orden (gradiente, pesos del bloque, L2-Hys
+// con 4 carriles), así que cualquier diferencia es un error. Requiere compilar sin contracción
+// a FMA (-ffp-contract=off), que redondea distinto que OpenCV.
+
+bool checkHOGParity(const Mat& scene) {
+    HOGDescriptor hog(Size(64, 128), Size(16, 16), Size(8, 8), Size(8, 8), 9);
+    unique_ptr<HOGScorer> kernel = createHOGScorer(hog.winSize, vector<float>(), hog.gammaCorrection);
+    if (!kernel) {
+        cerr << "❌ Paridad HOG: no hay kernel para " << hog.winSize << endl;
+        return false;
+    }
+
+    Mat gray;
+    cvtColor(scene, gray, COLOR_BGR2GRAY);
+    RNG rng(SCENE_SEED);
+    float maxDiff = 0.f;
+    for (int k = 0; k < 16; k++) {
+        Rect win(rng.uniform(0, scene.cols - 64), rng.uniform(0, scene.rows - 128), 64, 128);
+        for (const Mat& src : {scene, gray}) {
+            Mat patch = src(win).clone();
+            vector<float> ref, mine;
+            hog.compute(patch, ref);
+            kernel->compute(patch, mine);
+            if (ref.size() != mine.size()) {
+                cerr << "❌ Paridad HOG: tamaño " << mine.size() << " != " << ref.size() << endl;
+                return false;
+            }
+            for (size_t i = 0; i < ref.size(); i++) maxDiff = max(maxDiff, abs(ref[i] - mine[i]));
+        }
+    }
+
+    cout << (maxDiff <= PARITY_TOLERANCE ? "✅" : "❌") << " Paridad HOG (kernel vs HOGDescriptor): diferencia máx. "
+         << maxDiff << endl;
+    return maxDiff <= PARITY_TOLERANCE;
+}
+
+// ================= LÍNEA BASE =================
+
+// threads = hilos con los que se midió (-1 si el archivo no existe)
+map<string, double> loadBaseline(const string& path, int& threads) {
+    map<string, double> baseline;
+    threads = -1;
+    FileStorage fsIn(path, FileStorage::READ);
+    if (!fsIn.isOpened()) return baseline;
+    threads = fsIn["threads"].empty() ? 1 : (int)fsIn["threads"];
+    for (const auto& node : fsIn["benchmarks"]) {
+        baseline[(string)node["name"]] = (double)node["medianUs"];
+    }
+    return baseline;
+}
+
+bool saveBaseline(const string& path, const map<string, double>& medians, int threads) {
+    FileStorage fsOut(path, FileStorage::WRITE);
+    if (!fsOut.isOpened()) return false;
+    fsOut << "threads" << threads;
+    fsOut << "benchmarks" << "[";
+    for (const auto& m : medians) {
+        fsOut << "{" << "name" << m.first << "medianUs" << m.second << "}";
+    }
+    fsOut << "]";
+    return true;
+}
+
+int main(int argc, char** argv) {
+    string baselinePath = DEFAULT_BASELINE;
+    string clipsDir;
+    string filter;
+    double maxSlowdown = DEFAULT_MAX_SLOWDOWN;
+    bool save = false;
+    int threads = 1; // Un hilo por defecto: los tiempos varían mucho menos entre ejecuciones
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--baseline" && i + 1 < argc) baselinePath = argv[++i];
+        else if (arg == "--save-baseline") save = true;
+        else if (arg == "--max-slowdown" && i + 1 < argc) maxSlowdown = atof(argv[++i]);
+        else if (arg == "--clips" && i + 1 < argc) clipsDir = argv[++i];
+        else if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = max(1, atoi(argv[++i]));
+        else {
+            cout << "Uso: " << argv[0] << " [--baseline archivo.yml] [--save-baseline] [--max-slowdown 1.25] "
+                 << "[--clips dir] [--filter texto] [--threads N]" << endl;
+            return arg == "--help" ? 0 : -1;
+        }
+    }
+    setNumThreads(threads);
+
+    // --------- DATOS DE ENTRADA ---------
+    map<string, vector<Mat>> sequences;
+    for (const auto& light : SCENE_LIGHTS) sequences[light.second] = makeSequence(light.first);
+
+    map<string, vector<Mat>> clips;
+    if (!clipsDir.empty() && fs::is_directory(clipsDir)) {
+        for (const auto& entry : fs::directory_iterator(clipsDir)) {
+            string ext = entry.path().extension().string();
+            if (ext != ".mp4" && ext != ".avi" && ext != ".mkv" && ext != ".mov") continue;
+            vector<Mat> frames = loadClip(entry.path().string());
+            if (!frames.empty()) clips[entry.path().stem().string()] = frames;
+        }
+    }
+    cout << "[INFO] Escenas sintéticas: " << sequences.size() << " x " << SEQUENCE_FRAMES << " frames | Clips: "
+         << clips.size() << " | Hilos OpenCV: " << threads << endl;
+
+    const Mat& scene = sequences["normal"][0];
+    if (!checkHOGParity(scene)) return 2;
+
+    // --------- REGISTRO DE BENCHMARKS ---------
+    vector<pair<string, function<double()>>> benches;
+
+    map<string, Mat> grays, blurred;
+    map<string, LightingAnalysis> analyses;
+    for (const auto& light : SCENE_LIGHTS) {
+        const string& name = light.second;
+        cvtColor(sequences[name][0], grays[name], COLOR_BGR2GRAY);
+        GaussianBlur(grays[name], blurred[name], Size(5, 5), 0);
+        analyses[name] = analyzeLighting(grays[name]);
+    }
+    for (const auto& light : SCENE_LIGHTS) {
+        const string name = light.second;
+        benches.push_back({"analyzeLighting/" + name, [&, name] {
+            return analyzeLighting(grays[name]).meanBrightness;
+        }});
+    }
+    for (const auto& light : SCENE_LIGHTS) {
+        const string name = light.second;
+        benches.push_back({"correctLighting/" + name, [&, name] {
+            return (double)correctLighting(blurred[name], analyses[name]).at<uchar>(0, 0);
+        }});
+    }
+
+    // Iluminación por frame (análisis + corrección completos) frente al seguimiento incremental,
+    // ambos sobre la secuencia completa en gris
+    map<string, vector<Mat>> graySequences;
+    map<string, unique_ptr<LightingTracker>> lightingTrackers;
+    for (const auto& light : SCENE_LIGHTS) {
+        const string name = light.second;
+        for (const auto& f : sequences[name]) {
+            Mat g;
+            cvtColor(f, g, COLOR_BGR2GRAY);
+            graySequences[name].push_back(g);
+        }
+        const vector<Mat>* seq = &graySequences[name];
+        auto frameIdx = make_shared<size_t>(0);
+        benches.push_back({"lightingPerFrame/" + name, [seq, frameIdx] {
+            const Mat& gray = (*seq)[(*frameIdx)++ % seq->size()];
+            return (double)correctLighting(gray, analyzeLighting(gray)).at<uchar>(0, 0);
+        }});
+
+        lightingTrackers[name].reset(new LightingTracker());
+        LightingTracker* tracker = lightingTrackers[name].get();
+        auto trackerIdx = make_shared<size_t>(0);
+        auto output = make_shared<Mat>();
+        benches.push_back({"lightingTracker/" + name, [seq, tracker, trackerIdx, output] {
+            const Mat& gray = (*seq)[(*trackerIdx)++ % seq->size()];
+            tracker->update(gray);
+            tracker->correct(gray, *output);
+            return (double)output->at<uchar>(0, 0);
+        }});
+    }
+
+    // Cajas aleatorias con tamaños de persona, agrupadas como las devuelve HOG
+    RNG rng(SCENE_SEED);
+    vector<Rect> boxes, otherBoxes;
+    vector<double> boxWeights;
+    for (int i = 0; i < 1000; i++) {
+        int h = rng.uniform(64, 400), w = cvRound(h / rng.uniform(1.0, 3.5));
+        boxes.push_back(Rect(rng.uniform(0, FRAME_SIZE.width - w), rng.uniform(0, FRAME_SIZE.height - h), w, h));
+        otherBoxes.push_back(boxes.back() + Point(rng.uniform(-20, 20), rng.uniform(-20, 20)));
+        boxWeights.push_back(rng.uniform(0.0, 3.0));
+    }
+    benches.push_back({"isValidDetection/1000", [&] {
+        int valid = 0;
+        for (size_t i = 0; i < boxes.size(); i++) {
+            valid += isValidDetection(boxes[i], boxWeights[i], FRAME_SIZE.width, FRAME_SIZE.height);
+        }
+        return (double)valid;
+    }});
+    benches.push_back({"computeIoU/1000", [&] {
+        double sum = 0;
+        for (size_t i = 0; i < boxes.size(); i++) sum += computeIoU(boxes[i], otherBoxes[i]);
+        return sum;
+    }});
+
+    vector<Rect> nmsBoxes;
+    vector<double> nmsWeights;
+    for (int i = 0; i < 200; i++) {
+        Rect base = boxes[i % 8];
+        nmsBoxes.push_back(base + Point(rng.uniform(-12, 12), rng.uniform(-12, 12)));
+        nmsWeights.push_back(rng.uniform(0.5, 3.0));
+    }
+    benches.push_back({"improvedNMS/200", [&] {
+        return (double)improvedNMS(nmsBoxes, nmsWeights, 0.3).size();
+    }});
+
+    HOGDescriptor peopleHog;
+    peopleHog.setSVMDetector(HOGDescriptor::getDefaultPeopleDetector());
+    unique_ptr<HOGScorer> peopleKernel = createHOGScorer(peopleHog.winSize, HOGDescriptor::getDefaultPeopleDetector(),
+                                                         peopleHog.gammaCorrection);
+    const Mat& hogInput = blurred["normal"];
+    // Sin padding, igual que el kernel: así la comparación mide el mismo trabajo
+    benches.push_back({"hog/detectMultiScale", [&] {
+        vector<Rect> found;
+        vector<double> w;
+        peopleHog.detectMultiScale(hogInput, found, w, 0, Size(8, 8), Size(0, 0), 1.05, 2);
+        return (double)found.size();
+    }});
+    if (peopleKernel) {
+        benches.push_back({"hog/kernelDetectMultiScale", [&] {
+            vector<Rect> found;
+            vector<double> w;
+            peopleKernel->detectMultiScale(hogInput, found, w, 0, 8, 1.05, 2);
+            return (double)found.size();
+        }});
+    }
+    ZoneSet fullFrame;
+    benches.push_back({"hog/zonesDetect", [&] {
+        vector<Rect> found;
+        vector<double> w;
+        vector<int> zoneOf;
+        fullFrame.detect(hogInput, peopleHog, Size(8, 8), 1.05, found, w, zoneOf);
+        return (double)found.size();
+    }});
+
+    Mat crop = scene(Rect(200, 150, 120, 300)).clone();
+    benches.push_back({"encodeCrop/120x300", [&] {
+        return (double)PoseClient::encodeCrop(crop).size();
+    }});
+
+    // Frame completo: cada llamada procesa el siguiente frame de la secuencia (estado en régimen)
+    map<string, unique_ptr<Pipeline>> pipelines;
+    auto addPipeline = [&](const string& name, const vector<Mat>& frames) {
+        pipelines[name].reset(new Pipeline());
+        Pipeline* p = pipelines[name].get();
+        const vector<Mat>* seq = &frames;
+        benches.push_back({name, [p, seq] {
+            return (double)p->process((*seq)[p->frameCounter % seq->size()]);
+        }});
+    };
+    for (const auto& light : SCENE_LIGHTS) addPipeline("frame/" + light.second, sequences[light.second]);
+    for (const auto& clip : clips) addPipeline("clip/" + clip.first, clip.second);
+
+    // --------- EJECUCIÓN ---------
+    int baselineThreads;
+    map<string, double> baseline = loadBaseline(baselinePath, baselineThreads);
+    // Los tiempos con otro número de hilos no son comparables
+    if (!baseline.empty() && baselineThreads != threads) {
+        if (!save) {
+            cerr << "❌ La línea base se midió con " << baselineThreads << " hilo(s) y esta ejecución usa "
+                 << threads << ": usa --threads " << baselineThreads << " o regenera la línea base" << endl;
+            return -1;
+        }
+        cout << "⚠️  La línea base anterior usaba " << baselineThreads << " hilo(s): se descartan sus "
+             << baseline.size() << " entradas" << endl;
+        baseline.clear();
+    }
+    vector<BenchResult> results;
+    int regressions = 0;
+
+    cout << "-----------------------------------------------------------------------------" << endl;
+    cout << left << setw(32) << "Benchmark" << right << setw(12) << "Mediana us" << setw(12) << "Mín. us"
+         << setw(10) << "Base us" << setw(10) << "Ratio" << endl;
+    cout << "-----------------------------------------------------------------------------" << endl;
+    for (const auto& b : benches) {
+        if (!filter.empty() && b.first.find(filter) == string::npos) continue;
+        BenchResult r = runBench(b.first, b.second);
+        results.push_back(r);
+
+        cout << left << setw(32) << r.name << right << fixed << setprecision(2)
+             << setw(12) << r.medianUs << setw(12) << r.minUs;
+        auto it = baseline.find(r.name);
+        if (it != baseline.end() && it->second > 0) {
+            double ratio = r.medianUs / it->second;
+            bool slow = ratio > maxSlowdown;
+            if (slow) regressions++;
+            cout << setw(10) << it->second << setw(9) << ratio << "x" << (slow ? "  ❌ REGRESIÓN" : "");
+        }
+        cout << defaultfloat << endl;
+    }
+    cout << "-----------------------------------------------------------------------------" << endl;
+
+    if (save) {
+        // Se fusiona con la línea base existente: con --filter solo se actualizan los medidos
+        map<string, double> merged = baseline;
+        for (const auto& r : results) merged[r.name] = r.medianUs;
+        if (!saveBaseline(baselinePath, merged, threads)) {
+            cerr << "❌ ERROR: no se pudo escribir " << baselinePath << endl;
+            return -1;
+        }
+        cout << "💾 Línea base guardada: " << baselinePath << " (" << results.size() << " medidos, "
+             << merged.size() - results.size() << " conservados)" << endl;
+        return 0;
+    }
+    if (baseline.empty()) {
+        cout << "⚠️  Sin línea base en " << baselinePath << " (usa --save-baseline para crearla)" << endl;
+        return 0;
+    }
+    if (regressions > 0) {
+        cout << "❌ " << regressions << " benchmark(s) más lentos que " << maxSlowdown << "x la línea base" << endl;
+        return 1;
+    }
+    cout << "✅ Sin regresiones (umbral " << maxSlowdown << "x)" << endl;
+    return 0;
+}
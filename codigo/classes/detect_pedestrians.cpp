@@ -8,13 +8,31 @@
 #include <curl/curl.h>
 #include <numeric>
 #include <deque>
+#include "../cabezeras/ComputeGovernor.h"
+#include "../cabezeras/FeatureTracker.h"
+#include "../cabezeras/PoseClient.h"
+#include "../cabezeras/DetectionSpool.h"
+#include "../cabezeras/DetectionZones.h"
+#include "../cabezeras/DetectionFilters.h"
+#include "../cabezeras/LightingCorrection.h"
 
 using namespace cv;
 using namespace std;
 
 // --- CONFIGURACIÓN ---
-const string API_URL = "http://localhost:8000/detect";
+const string API_BASE_URL = "http://localhost:8000";
+const int BATCH_WINDOW_MS = 0;    // Agrupar recortes de varios frames (0 = un lote por frame)
+const size_t BATCH_MAX_CROPS = 8;
+const string SPOOL_DIR = "spool";            // Cola en disco cuando la API está lenta o caída
+const size_t SPOOL_MAX_BYTES = 256u << 20;   // Tope de disco (se desaloja lo más antiguo)
 const int CAPTURE_COOLDOWN_MS = 2500;
+const double TARGET_FPS = 15.0;   // Objetivo del gobernador (0 = desactivado)
+const double CPU_CAP = 75.0;      // Tope de CPU del sistema en % (0 = desactivado)
+const FeatureMode FEATURE_MODE = FeatureMode::KLT; // OFF / ORB / KLT
+const int MAX_STATIC_SKIP = 10;   // Con escena estática, detectar al menos 1 de cada N frames
+const int LIGHTING_FULL_EVERY = 15;   // Análisis completo de luz 1 de cada N frames (o si hay deriva)
+const double LIGHTING_DRIFT = 8.0;    // Desvío de brillo medio que fuerza un análisis
+const string ZONES_DIR = "zones";  // zones/camera<índice>.yml; sin archivo se usa el frame completo
 auto lastCaptureTime = chrono::steady_clock::now();
 
 // --- FUNCIONES DE TELEMETRÍA ---
@@ -56,202 +74,6 @@ double getMemoryUsage() {
     return 0.0;
 }
 
-// --- ANÁLISIS DE ILUMINACIÓN ---
-struct LightingAnalysis {
-    double meanBrightness;
-    double stdDevBrightness;
-    bool isBacklit;
-    bool isOverexposed;
-    bool isUnderexposed;
-    bool hasHighContrast;
-    double dynamicRange;
-};
-
-LightingAnalysis analyzeLighting(const Mat& gray) {
-    LightingAnalysis result;
-    
-    // Calcular estadísticas básicas
-    Scalar mean, stddev;
-    meanStdDev(gray, mean, stddev);
-    result.meanBrightness = mean[0];
-    result.stdDevBrightness = stddev[0];
-    
-    // Calcular histograma
-    Mat hist;
-    int histSize = 256;
-    float range[] = {0, 256};
-    const float* histRange = {range};
-    calcHist(&gray, 1, 0, Mat(), hist, 1, &histSize, &histRange);
-    
-    // Normalizar histograma
-    normalize(hist, hist, 0, gray.rows * gray.cols, NORM_MINMAX);
-    
-    // Análisis de distribución de luminosidad
-    float darkPixels = 0, brightPixels = 0, midPixels = 0;
-    for (int i = 0; i < 85; i++) darkPixels += hist.at<float>(i);
-    for (int i = 85; i < 170; i++) midPixels += hist.at<float>(i);
-    for (int i = 170; i < 256; i++) brightPixels += hist.at<float>(i);
-    
-    float totalPixels = gray.rows * gray.cols;
-    
-    // Detección de contraluz (backlight)
-    // Hay mucha luminosidad en los bordes y oscuridad en el centro
-    Rect centerROI(gray.cols * 0.3, gray.rows * 0.3, gray.cols * 0.4, gray.rows * 0.4);
-    Rect edgeROI1(0, 0, gray.cols, gray.rows * 0.2); // Top edge
-    Mat centerRegion = gray(centerROI);
-    Mat edgeRegion = gray(edgeROI1);
-    
-    double centerMean = cv::mean(centerRegion)[0];
-    double edgeMean = cv::mean(edgeRegion)[0];
-    
-    result.isBacklit = (edgeMean - centerMean > 50) && (brightPixels / totalPixels > 0.25);
-    
-    // Detección de sobreexposición
-    result.isOverexposed = (result.meanBrightness > 200) || (brightPixels / totalPixels > 0.4);
-    
-    // Detección de subexposición
-    result.isUnderexposed = (result.meanBrightness < 60) || (darkPixels / totalPixels > 0.5);
-    
-    // Detección de alto contraste
-    result.hasHighContrast = result.stdDevBrightness > 60;
-    
-    // Rango dinámico
-    double minVal, maxVal;
-    minMaxLoc(gray, &minVal, &maxVal);
-    result.dynamicRange = maxVal - minVal;
-    
-    return result;
-}
-
-// --- CORRECCIÓN AUTOMÁTICA DE ILUMINACIÓN ---
-Mat correctLighting(const Mat& input, const LightingAnalysis& analysis) {
-    Mat corrected = input.clone();
-    
-    // Si hay contraluz, aplicar ecualización adaptativa más agresiva
-    if (analysis.isBacklit) {
-        Ptr<CLAHE> clahe = createCLAHE(3.0, Size(8, 8));
-        clahe->apply(corrected, corrected);
-        
-        // Además, aplicar corrección gamma para levantar sombras
-        Mat lookUpTable(1, 256, CV_8U);
-        uchar* p = lookUpTable.ptr();
-        double gamma = 0.7; // Gamma < 1 levanta sombras
-        for(int i = 0; i < 256; ++i) {
-            p[i] = saturate_cast<uchar>(pow(i / 255.0, gamma) * 255.0);
-        }
-        LUT(corrected, lookUpTable, corrected);
-    }
-    // Si está sobreexpuesto, reducir brillo
-    else if (analysis.isOverexposed) {
-        Ptr<CLAHE> clahe = createCLAHE(1.0, Size(16, 16));
-        clahe->apply(corrected, corrected);
-        corrected = corrected * 0.8; // Reducir 20% brillo
-    }
-    // Si está subexpuesto, aumentar brillo
-    else if (analysis.isUnderexposed) {
-        Ptr<CLAHE> clahe = createCLAHE(2.5, Size(8, 8));
-        clahe->apply(corrected, corrected);
-        
-        // Gamma para aclarar
-        Mat lookUpTable(1, 256, CV_8U);
-        uchar* p = lookUpTable.ptr();
-        double gamma = 1.3; // Gamma > 1 aclara
-        for(int i = 0; i < 256; ++i) {
-            p[i] = saturate_cast<uchar>(pow(i / 255.0, gamma) * 255.0);
-        }
-        LUT(corrected, lookUpTable, corrected);
-    }
-    // Condiciones normales
-    else {
-        Ptr<CLAHE> clahe = createCLAHE(1.5, Size(8, 8));
-        clahe->apply(corrected, corrected);
-    }
-    
-    return corrected;
-}
-
-// --- API SEND ---
-size_t write_callback(void *ptr, size_t size, size_t nmemb, void *userdata) { return size * nmemb; }
-
-void sendToAPI(Mat frame) {
-    CURL *curl = curl_easy_init();
-    if(curl) {
-        vector<uchar> buf;
-        imencode(".jpg", frame, buf, {IMWRITE_JPEG_QUALITY, 85});
-        curl_mime *form = curl_mime_init(curl);
-        curl_mimepart *field = curl_mime_addpart(form);
-        curl_mime_name(field, "file");
-        curl_mime_data(field, (const char*)buf.data(), buf.size());
-        curl_mime_filename(field, "detection.jpg");
-        curl_mime_type(field, "image/jpeg");
-        curl_easy_setopt(curl, CURLOPT_URL, API_URL.c_str());
-        curl_easy_setopt(curl, CURLOPT_MIMEPOST, form);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 2L);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-        curl_easy_perform(curl);
-        curl_mime_free(form);
-        curl_easy_cleanup(curl);
-    }
-}
-
-// --- FILTRO DE DETECCIONES ---
-bool isValidDetection(Rect r, double weight, int frameWidth, int frameHeight) {
-    if (weight < 0.8) return false;
-    
-    int minWidth = frameWidth * 0.08;
-    int maxWidth = frameWidth * 0.7;
-    int minHeight = frameHeight * 0.15;
-    int maxHeight = frameHeight * 0.9;
-    
-    if (r.width < minWidth || r.width > maxWidth) return false;
-    if (r.height < minHeight || r.height > maxHeight) return false;
-    
-    float aspectRatio = (float)r.height / (float)r.width;
-    if (aspectRatio < 1.2 || aspectRatio > 4.0) return false;
-    
-    int minArea = (frameWidth * frameHeight) * 0.02;
-    if (r.area() < minArea) return false;
-    
-    return true;
-}
-
-// --- SUPRESIÓN NO MÁXIMA MEJORADA ---
-vector<Rect> improvedNMS(vector<Rect> &boxes, vector<double> &weights, float overlapThresh = 0.3) {
-    if (boxes.empty()) return {};
-    
-    vector<Rect> result;
-    vector<int> indices(boxes.size());
-    iota(indices.begin(), indices.end(), 0);
-    
-    sort(indices.begin(), indices.end(), [&weights](int i1, int i2) {
-        return weights[i1] > weights[i2];
-    });
-    
-    vector<bool> suppressed(boxes.size(), false);
-    
-    for (size_t i = 0; i < indices.size(); i++) {
-        int idx = indices[i];
-        if (suppressed[idx]) continue;
-        
-        result.push_back(boxes[idx]);
-        
-        for (size_t j = i + 1; j < indices.size(); j++) {
-            int idx2 = indices[j];
-            if (suppressed[idx2]) continue;
-            
-            Rect intersection = boxes[idx] & boxes[idx2];
-            float iou = (float)intersection.area() / 
-                       (float)(boxes[idx].area() + boxes[idx2].area() - intersection.area());
-            
-            if (iou > overlapThresh) {
-                suppressed[idx2] = true;
-            }
-        }
-    }
-    
-    return result;
-}
-
 int main() {
     VideoCapture cap;
     
@@ -259,6 +81,7 @@ int main() {
     int backends[] = {CAP_ANY, CAP_V4L2};
     int indices[] = {0, 2, 1};
     bool is_opened = false;
+    int cameraIndex = -1;
 
     cout << "🔍 Buscando cámara disponible..." << endl;
 
@@ -268,6 +91,7 @@ int main() {
             cap.open(i, b);
             if (cap.isOpened()) {
                 is_opened = true;
+                cameraIndex = i;
                 break;
             }
         }
@@ -291,21 +115,43 @@ int main() {
 
     HOGDescriptor hog;
     hog.setSVMDetector(HOGDescriptor::getDefaultPeopleDetector());
+
+    // Zonas de interés de esta cámara: HOG solo barre dentro de ellas
+    ZoneSet zones;
+    bool hasZones = zones.load(ZONES_DIR + "/camera" + to_string(cameraIndex) + ".yml");
     
-    Ptr<SIFT> sift = SIFT::create(100);
-    vector<KeyPoint> keypoints;
+    // Seguimiento de puntos clave: reemplaza a SIFT y estima el movimiento de cámara
+    FeatureTracker tracker(FEATURE_MODE, 100);
+    int framesSinceDetect = 0;
     
     TickMeter tm;
-    Mat frame, gray, blurred, corrected;
+    Mat frame, gray, blurred, corrected, detectInput;
     int frameCounter = 0;
     CPUStats prevCPU = getCPUStats();
     double cpuUsage = 0.0;
+
+    // Gobernador de cómputo: ajusta escala/stride/saltos para sostener el objetivo
+    ComputeGovernor governor(TARGET_FPS, CPU_CAP);
+    StageTimings timings = {0, 0, 0, 0};
+
+    // Resultados de la última detección (se reutilizan en los frames saltados)
+    vector<Rect> validBoxes, finalBoxes;
+    vector<double> validWeights;
+    int rejected = 0;
     
+    // Iluminación incremental: modo estable y corrección cacheada por modo
+    LightingTracker lightingTracker(LIGHTING_FULL_EVERY, 4, LIGHTING_DRIFT);
+
     // Historial de condiciones de luz para suavizar cambios
     deque<double> brightnessHistory;
     const int HISTORY_SIZE = 10;
 
     curl_global_init(CURL_GLOBAL_ALL);
+    PoseBatcher poseBatcher(BATCH_WINDOW_MS, BATCH_MAX_CROPS);
+    // El detector solo escribe en el spool; el envío a la API corre en su propio hilo
+    DetectionSpool spool(SPOOL_DIR, PoseClient(API_BASE_URL), SPOOL_MAX_BYTES, 4u << 20, BATCH_MAX_CROPS,
+                         BATCH_WINDOW_MS);
+    spool.start();
 
     cout << "✅ ¡Cámara conectada con éxito!" << endl;
     cout << "🎯 Sistema adaptativo de iluminación activado" << endl;
@@ -318,15 +164,23 @@ int main() {
             cerr << "Frame vacío, reintentando..." << endl;
             continue;
         }
+        // El gobernador mide solo el procesamiento: la espera de la cámara no baja con los niveles
+        auto processStart = chrono::steady_clock::now();
 
         flip(frame, frame, 1);
         cvtColor(frame, gray, COLOR_BGR2GRAY);
         
+        const DetectionKnobs& knobs = governor.knobs();
+        auto stageStart = chrono::steady_clock::now();
+        auto msSince = [](chrono::steady_clock::time_point t0) {
+            return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        };
+
         // ===== ANÁLISIS DE ILUMINACIÓN =====
-        LightingAnalysis lighting = analyzeLighting(gray);
+        LightingMode lightingMode = lightingTracker.update(gray);
         
         // Mantener historial de brillo para suavizar
-        brightnessHistory.push_back(lighting.meanBrightness);
+        brightnessHistory.push_back(lightingTracker.getMeanBrightness());
         if (brightnessHistory.size() > HISTORY_SIZE) {
             brightnessHistory.pop_front();
         }
@@ -339,35 +193,69 @@ int main() {
         // Aplicar desenfoque gaussiano para reducir ruido
         GaussianBlur(gray, blurred, Size(5, 5), 0);
         
-        // Aplicar corrección según condiciones de luz
-        corrected = correctLighting(blurred, lighting);
-
-        // ===== DETECCIÓN SIFT =====
-        if (frameCounter % 5 == 0) sift->detect(corrected, keypoints);
-        drawKeypoints(frame, keypoints, frame, Scalar(0, 255, 0), DrawMatchesFlags::DEFAULT);
+        // Aplicar corrección según el modo de luz (sin reconstruir CLAHE/LUT)
+        lightingTracker.correct(blurred, corrected);
+        timings.lightingMs = msSince(stageStart);
+
+        // ===== SEGUIMIENTO DE PUNTOS CLAVE =====
+        // Se sigue sobre la imagen suavizada (no la corregida) para que el cambio de modo
+        // de iluminación no rompa la constancia de brillo del flujo óptico
+        stageStart = chrono::steady_clock::now();
+        tracker.process(blurred, frameCounter % knobs.featureEvery == 0);
+        for (const auto& p : tracker.getPoints()) {
+            circle(frame, Point(cvRound(p.x), cvRound(p.y)), 3, Scalar(0, 255, 0), 1);
+        }
+        timings.featuresMs = msSince(stageStart);
 
         // ===== DETECCIÓN HOG =====
-        vector<Rect> found;
-        vector<double> weights;
-        
-        hog.detectMultiScale(corrected, found, weights, 0, Size(8,8), Size(32,32), 1.05, 2);
-
-        // ===== FILTRADO ESTRICTO =====
-        vector<Rect> validBoxes;
-        vector<double> validWeights;
-        int rejected = 0;
-        
-        for (size_t i = 0; i < found.size(); i++) {
-            if (isValidDetection(found[i], weights[i], frame.cols, frame.rows)) {
-                validBoxes.push_back(found[i]);
-                validWeights.push_back(weights[i]);
+        // Escena estática: reutilizar las cajas anteriores, con un refresco mínimo garantizado
+        bool detectThisFrame = (frameCounter % knobs.detectEvery == 0);
+        if (detectThisFrame && tracker.isStatic() && framesSinceDetect < MAX_STATIC_SKIP) {
+            detectThisFrame = false;
+        }
+        framesSinceDetect = detectThisFrame ? 0 : framesSinceDetect + 1;
+        stageStart = chrono::steady_clock::now();
+        if (detectThisFrame) {
+            vector<Rect> found;
+            vector<double> weights;
+            vector<int> zoneOf;
+
+            // Reducir la imagen si el gobernador lo pide; las cajas se reescalan al original
+            if (knobs.downscale < 1.0) {
+                resize(corrected, detectInput, Size(), knobs.downscale, knobs.downscale, INTER_AREA);
             } else {
-                rejected++;
+                detectInput = corrected;
+            }
+
+            zones.detect(detectInput, hog, Size(knobs.winStride, knobs.winStride), knobs.hogScale,
+                         found, weights, zoneOf);
+
+            if (knobs.downscale < 1.0) {
+                double inv = 1.0 / knobs.downscale;
+                for (auto& r : found) {
+                    r = Rect(cvRound(r.x * inv), cvRound(r.y * inv),
+                             cvRound(r.width * inv), cvRound(r.height * inv));
+                }
             }
+
+            // ===== FILTRADO ESTRICTO =====
+            validBoxes.clear();
+            validWeights.clear();
+            rejected = 0;
+
+            for (size_t i = 0; i < found.size(); i++) {
+                if (isValidDetection(found[i], weights[i], frame.cols, frame.rows, zones.zone(zoneOf[i]).filter)) {
+                    validBoxes.push_back(found[i]);
+                    validWeights.push_back(weights[i]);
+                } else {
+                    rejected++;
+                }
+            }
+
+            // Aplicar NMS mejorada
+            finalBoxes = improvedNMS(validBoxes, validWeights, 0.3);
         }
-        
-        // Aplicar NMS mejorada
-        vector<Rect> finalBoxes = improvedNMS(validBoxes, validWeights, 0.3);
+        timings.detectionMs = msSince(stageStart);
 
         auto currentTime = chrono::steady_clock::now();
         auto elapsed = chrono::duration_cast<chrono::milliseconds>(currentTime - lastCaptureTime).count();
@@ -383,27 +271,43 @@ int main() {
                 putText(frame, confText, Point(finalBoxes[i].x, finalBoxes[i].y - 5), 
                         FONT_HERSHEY_SIMPLEX, 0.5, color, 2);
                 
-                if (elapsed >= CAPTURE_COOLDOWN_MS) {
+                // Solo se envían recortes de detecciones frescas, no de cajas reutilizadas
+                if (detectThisFrame && elapsed >= CAPTURE_COOLDOWN_MS) {
                     Rect safeROI = finalBoxes[i] & Rect(0, 0, frame.cols, frame.rows);
                     if (safeROI.width > 0 && safeROI.height > 0) {
-                        sendToAPI(frame(safeROI)); 
+                        poseBatcher.add(frame(safeROI), safeROI, validWeights[idx]);
                         lastCaptureTime = currentTime;
-                        cout << "📡 API Sent | Conf: " << validWeights[idx] << endl;
                     }
                 }
             }
         }
 
+        // El lote va al spool en disco; el hilo de envío lo agrupa en una sola petición a la API
+        if (poseBatcher.due()) {
+            vector<PoseCrop> batch = poseBatcher.take();
+            if (spool.append(batch)) {
+                cout << "💾 Spool | Lote: " << batch.size() << " | Pendiente: "
+                     << spool.pendingBytes() / 1024 << " KB" << endl;
+            }
+        }
+
         tm.stop();
         
-        if (frameCounter % 10 == 0) {
+        bool cpuSampled = frameCounter % 10 == 0;
+        if (cpuSampled) {
             CPUStats currCPU = getCPUStats();
             cpuUsage = calculateCPUUsage(prevCPU, currCPU);
             prevCPU = currCPU;
         }
 
+        // ===== GOBERNADOR DE CÓMPUTO =====
+        // La CPU solo se reporta en los frames con muestra nueva (-1 = sin muestra)
+        timings.totalMs = msSince(processStart);
+        governor.update(timings, cpuSampled ? cpuUsage : -1.0);
+
         // ===== PANEL DE TELEMETRÍA EXPANDIDO =====
-        rectangle(frame, Rect(5, 5, 290, 210), Scalar(0,0,0), -1);
+        if (hasZones) zones.draw(frame);
+        rectangle(frame, Rect(5, 5, 290, 250), Scalar(0,0,0), -1);
         
         putText(frame, "FPS: " + to_string((int)tm.getFPS()), Point(15, 25), 
                 FONT_HERSHEY_SIMPLEX, 0.5, Scalar(0, 255, 255), 1);
@@ -420,13 +324,13 @@ int main() {
         
         Scalar statusColor = Scalar(0, 255, 0);
         string status = "OK";
-        if (lighting.isBacklit) {
+        if (lightingMode == LightingMode::BACKLIT) {
             status = "BACKLIT!";
             statusColor = Scalar(0, 165, 255);
-        } else if (lighting.isOverexposed) {
+        } else if (lightingMode == LightingMode::OVEREXPOSED) {
             status = "OVEREXP";
             statusColor = Scalar(0, 100, 255);
-        } else if (lighting.isUnderexposed) {
+        } else if (lightingMode == LightingMode::UNDEREXPOSED) {
             status = "UNDEREXP";
             statusColor = Scalar(255, 100, 0);
         }
@@ -440,6 +344,15 @@ int main() {
                 FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 255, 0), 1);
         putText(frame, "Rejected: " + to_string(rejected), Point(15, 205), 
                 FONT_HERSHEY_SIMPLEX, 0.4, Scalar(0, 100, 255), 1);
+        putText(frame, "Governor: L" + to_string(governor.getLevel()) + "/" +
+                to_string(governor.getNumLevels() - 1), Point(15, 225),
+                FONT_HERSHEY_SIMPLEX, 0.4, Scalar(200, 200, 200), 1);
+        const ZoneScanStats& scan = zones.getStats();
+        if (scan.fullWindows > 0) {
+            putText(frame, "Scan: " + to_string(100 * scan.windows / scan.fullWindows) + "% win, " +
+                    to_string(100 * scan.pixels / scan.fullPixels) + "% px", Point(15, 245),
+                    FONT_HERSHEY_SIMPLEX, 0.4, Scalar(200, 200, 200), 1);
+        }
 
         imshow("Webcam Monitor", frame);
         
@@ -449,6 +362,7 @@ int main() {
         if (waitKey(1) == 27) break; 
     }
 
+    spool.stop();
     curl_global_cleanup();
     cap.release();
     destroyAllWindows();
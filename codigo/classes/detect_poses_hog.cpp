@@ -2,59 +2,115 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <memory>
+#include <string>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <cstdint>
+#include "../cabezeras/HOGKernel.h"
 
 using namespace cv;
 using namespace std;
+namespace fs = std::filesystem;
 
-vector<float> loadCustomDetector(string path) {
-    vector<float> detector;
-    float value;
-    ifstream file(path);
-    if (!file.is_open()) return detector;
-    while (file >> value) detector.push_back(value);
-    file.close();
-    return detector;
-}
+// --- CONFIGURACIÓN ---
+const string DEFAULT_MODEL = "/home/jellz/Documents/VisionPorComputador/ProyectoDeteccion/python/custom_hog_detector.txt";
+const string DEFAULT_VIDEO = "/home/jellz/Documents/VisionPorComputador/ProyectoDeteccion/codigo/classes/videomall.mp4";
+const Size PROCESS_SIZE(640, 480);   // Resolución a la que se evalúa el modelo
+const double HIT_THRESHOLD = -0.5;
+const int DEFAULT_CHUNK = 16;         // Frames por bloque de trabajo en modo lote
+const int HOG_PADDING = 32;           // Relleno por nivel: personas pegadas al borde del frame
 
-int main() {
-    // 1. Configuración EXACTA del Descriptor (64x128)
+// Detector ya cargado: kernel especializado si existe (solo modo lote), HOGDescriptor si no
+struct PoseDetector {
+    // 1. Configuración EXACTA del Descriptor (64x128 por defecto; loadPoseDetector ajusta
+    // winSize a la dimensión del detector, p. ej. 64x64 del .yml de train_acf)
     // Estos parámetros deben ser idénticos a los de tu script de Python
-    HOGDescriptor hogCustom(
+    HOGDescriptor hog{
         Size(64, 128), // winSize
         Size(16, 16),  // blockSize
         Size(8, 8),    // blockStride
         Size(8, 8),    // cellSize
         9              // nbins
-    );
+    };
+    unique_ptr<HOGScorer> scorer;
 
-    string modelPath = "/home/jellz/Documents/VisionPorComputador/ProyectoDeteccion/python/custom_hog_detector.txt";
-    vector<float> myDetector = loadCustomDetector(modelPath);
+    // Seguro para llamar desde varios hilos (ambos caminos son const)
+    void detect(const Mat& img, vector<Rect>& found, vector<double>& weights) const {
+        if (scorer) {
+            scorer->detectMultiScale(img, found, weights, HIT_THRESHOLD, 8, 1.05, 2, HOG_PADDING);
+        } else {
+            hog.detectMultiScale(img, found, weights, HIT_THRESHOLD, Size(8,8), Size(HOG_PADDING, HOG_PADDING), 1.05, 2);
+        }
+    }
+};
 
+// useKernel: el kernel suma en otro orden (scores casi iguales, no idénticos); el modo
+// interactivo es un diagnóstico del modelo y se queda con HOGDescriptor
+bool loadPoseDetector(const string& modelPath, PoseDetector& det, bool useKernel) {
+    vector<float> myDetector = loadHOGDetector(modelPath);
     if (myDetector.empty()) {
-        cout << "❌ No se pudo cargar el archivo txt." << endl;
-        return -1;
+        cout << "❌ No se pudo cargar el detector: " << modelPath << endl;
+        return false;
+    }
+
+    // La ventana se deduce de la dimensión del detector (.txt de Python o .yml de train_acf)
+    Size winSize = hogWinSizeFor(myDetector.size());
+    if (winSize.area() == 0) {
+        cout << "❌ Detector de " << myDetector.size() << " valores: no corresponde a ninguna geometría conocida." << endl;
+        return false;
     }
+    det.hog.winSize = winSize;
 
     // Intentar asignar el detector
-    hogCustom.setSVMDetector(myDetector);
+    det.hog.setSVMDetector(myDetector);
+
+    // Kernel especializado para la geometría del modelo; si no hay, se usa HOGDescriptor
+    if (useKernel) det.scorer = createHOGScorer(det.hog.winSize, myDetector, det.hog.gammaCorrection);
+    if (det.scorer) {
+        cout << "⚡ Kernel HOG especializado " << det.scorer->winSize() << " (" << det.scorer->descriptorSize() << " dims)" << endl;
+
+        // Si existe el modelo int8 calibrado con quantize_svm, puntuar con enteros
+        string quantizedPath = fs::path(modelPath).replace_extension().string() + "_q8.yml";
+        QuantizedSVM q;
+        Size qWinSize;
+        if (loadQuantizedSVM(quantizedPath, q, qWinSize) && qWinSize == det.scorer->winSize()) {
+            if (!quantizedFrom(q, myDetector)) {
+                cout << "⚠️  " << quantizedPath << " no corresponde a este detector (¿reentrenado?): "
+                     << "se usa el SVM float. Vuelve a ejecutar quantize_svm." << endl;
+            } else if (det.scorer->setQuantized(q)) {
+                cout << "⚡ SVM cuantizado int8: " << quantizedPath << endl;
+            }
+        }
+    }
+    return true;
+}
 
-    VideoCapture cap("/home/jellz/Documents/VisionPorComputador/ProyectoDeteccion/codigo/classes/videomall.mp4");
+// ================= MODO INTERACTIVO =================
+int runInteractive(const PoseDetector& det, const string& videoPath) {
+    VideoCapture cap(videoPath);
     Mat frame;
 
     while (cap.read(frame)) {
-        resize(frame, frame, Size(640, 480));
+        resize(frame, frame, PROCESS_SIZE);
 
         vector<Rect> poses;
         vector<double> confidences;
 
         // --- TRUCO DE DIAGNÓSTICO ---
-        // Usamos detect() en lugar de detectMultiScale para ver los niveles de confianza reales
         // hitThreshold negativo (-0.5) para obligar al modelo a mostrar TODO lo que sospecha
-        hogCustom.detectMultiScale(frame, poses, -0.5, Size(8,8), Size(32,32), 1.05, 2);
+        det.detect(frame, poses, confidences);
 
         for (const auto& r : poses) {
             rectangle(frame, r, Scalar(255, 0, 0), 2); // Azul para poses raras
-            putText(frame, "SOSPECHA DE POSE", Point(r.x, r.y - 5), 
+            putText(frame, "SOSPECHA DE POSE", Point(r.x, r.y - 5),
                     FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 0, 0), 1);
         }
 
@@ -62,4 +118,336 @@ int main() {
         if (waitKey(1) == 27) break;
     }
     return 0;
-}
\ No newline at end of file
+}
+
+// ================= MODO LOTE =================
+// Un hilo decodifica, N hilos detectan bloques de frames en cualquier orden y el hilo
+// principal escribe los resultados en orden de frame.
+
+struct FrameChunk {
+    size_t index;          // Orden del bloque dentro de la fuente
+    uint32_t firstFrame;
+    vector<Mat> frames;
+};
+
+struct FrameDetection {
+    uint32_t frame;
+    Rect box;              // Coordenadas del frame original
+    float score;
+};
+
+struct ChunkResult {
+    vector<FrameDetection> detections;
+    size_t frames;
+};
+
+// Cola acotada: el decodificador se frena si los detectores no dan abasto (memoria acotada)
+class ChunkQueue {
+private:
+    deque<FrameChunk> items;
+    size_t capacity;
+    bool closed = false;
+    mutex mtx;
+    condition_variable notFull, notEmpty;
+
+public:
+    explicit ChunkQueue(size_t _capacity) : capacity(_capacity) {}
+
+    void push(FrameChunk&& chunk) {
+        unique_lock<mutex> lock(mtx);
+        notFull.wait(lock, [this] { return items.size() < capacity; });
+        items.push_back(std::move(chunk));
+        notEmpty.notify_one();
+    }
+
+    bool pop(FrameChunk& chunk) {
+        unique_lock<mutex> lock(mtx);
+        notEmpty.wait(lock, [this] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        chunk = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        lock_guard<mutex> lock(mtx);
+        closed = true;
+        notEmpty.notify_all();
+    }
+};
+
+// Fuente de frames: video o directorio de imágenes (orden alfabético = índice de frame)
+class FrameSource {
+private:
+    VideoCapture cap;
+    vector<string> images;
+    vector<string> decoded; // Imágenes leídas con éxito; su posición es el índice de frame
+    size_t next = 0;
+    bool isVideo = false;
+
+public:
+    bool open(const string& path) {
+        if (fs::is_directory(path)) {
+            for (const auto& entry : fs::directory_iterator(path)) {
+                string ext = entry.path().extension().string();
+                transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+                if (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp") {
+                    images.push_back(entry.path().string());
+                }
+            }
+            sort(images.begin(), images.end());
+            return !images.empty();
+        }
+        isVideo = true;
+        return cap.open(path);
+    }
+
+    bool read(Mat& frame) {
+        if (isVideo) return cap.read(frame);
+        while (next < images.size()) {
+            frame = imread(images[next++]);
+            if (!frame.empty()) {
+                decoded.push_back(images[next - 1]);
+                return true;
+            }
+            cerr << "Advertencia: no se pudo leer " << images[next - 1] << endl;
+        }
+        return false;
+    }
+
+    bool isDirectory() const { return !isVideo; }
+    const vector<string>& decodedImages() const { return decoded; }
+};
+
+// Archivo de resultados: cabecera "HOGD" + versión + tamaño del frame original,
+// luego registros de 16 bytes (frame u32, x/y/ancho/alto i16, score f32) en orden de frame.
+struct ResultsWriter {
+    ofstream out;
+
+    bool open(const string& path) {
+        out.open(path, ios::binary);
+        return out.is_open();
+    }
+
+    void writeHeader(uint32_t width, uint32_t height) {
+        const char magic[4] = {'H', 'O', 'G', 'D'};
+        uint32_t version = 1;
+        out.write(magic, 4);
+        out.write((const char*)&version, 4);
+        out.write((const char*)&width, 4);
+        out.write((const char*)&height, 4);
+    }
+
+    void write(const FrameDetection& d) {
+        int16_t box[4] = {saturate_cast<short>(d.box.x), saturate_cast<short>(d.box.y),
+                          saturate_cast<short>(d.box.width), saturate_cast<short>(d.box.height)};
+        out.write((const char*)&d.frame, 4);
+        out.write((const char*)box, sizeof(box));
+        out.write((const char*)&d.score, 4);
+    }
+};
+
+ChunkResult processChunk(const PoseDetector& det, const FrameChunk& chunk) {
+    ChunkResult result;
+    result.frames = chunk.frames.size();
+    Mat small;
+    vector<Rect> found;
+    vector<double> weights;
+
+    for (size_t i = 0; i < chunk.frames.size(); i++) {
+        const Mat& frame = chunk.frames[i];
+        resize(frame, small, PROCESS_SIZE);
+        det.detect(small, found, weights);
+
+        // Volver a coordenadas del frame original
+        double sx = (double)frame.cols / PROCESS_SIZE.width;
+        double sy = (double)frame.rows / PROCESS_SIZE.height;
+        for (size_t k = 0; k < found.size(); k++) {
+            Rect r(cvRound(found[k].x * sx), cvRound(found[k].y * sy),
+                   cvRound(found[k].width * sx), cvRound(found[k].height * sy));
+            float score = k < weights.size() ? (float)weights[k] : 0.f;
+            result.detections.push_back({chunk.firstFrame + (uint32_t)i, r, score});
+        }
+    }
+    return result;
+}
+
+// Nombre base de los resultados de una entrada: el del archivo o el del directorio
+string inputStem(const string& input) {
+    fs::path inPath = fs::path(input);
+    return inPath.has_filename() ? inPath.stem().string() : inPath.parent_path().filename().string();
+}
+
+// Nombres de salida únicos: cam1/video.mp4 y cam2/video.mp4 no deben pisarse en --out
+vector<string> uniqueStems(const vector<string>& inputs) {
+    vector<string> stems;
+    map<string, int> used;
+    for (const auto& input : inputs) {
+        string stem = inputStem(input);
+        if (used.count(stem)) {
+            string parent = fs::absolute(input).lexically_normal().parent_path().filename().string();
+            string candidate = parent.empty() ? stem : parent + "_" + stem;
+            for (int n = 2; used.count(candidate); n++) candidate = stem + "_" + to_string(n);
+            cout << "⚠️  " << input << " tiene el mismo nombre que otra entrada: resultados en " << candidate << ".det" << endl;
+            stem = candidate;
+        }
+        used[stem]++;
+        stems.push_back(stem);
+    }
+    return stems;
+}
+
+int runBatchOne(const PoseDetector& det, const string& input, const string& stem, const string& outDir,
+                int workers, int chunkSize) {
+    FrameSource source;
+    if (!source.open(input)) {
+        cerr << "❌ No se pudo abrir: " << input << endl;
+        return -1;
+    }
+
+    string outPath = (fs::path(outDir) / (stem + ".det")).string();
+    ResultsWriter writer;
+    if (!writer.open(outPath)) {
+        cerr << "❌ No se pudo escribir: " << outPath << endl;
+        return -1;
+    }
+
+    ChunkQueue queue(workers * 2);
+    mutex resultsMtx;
+    condition_variable resultReady;
+    map<size_t, ChunkResult> done;
+    size_t totalChunks = SIZE_MAX;   // Se conoce al terminar de decodificar
+    atomic<uint32_t> frameW(0), frameH(0);
+
+    // --- Decodificación dedicada ---
+    thread decoder([&] {
+        size_t pushed = 0;
+        uint32_t frameIdx = 0;
+        Mat frame;
+        FrameChunk chunk{0, 0, {}};
+        while (source.read(frame)) {
+            if (frameIdx == 0) {
+                frameW = frame.cols;
+                frameH = frame.rows;
+            }
+            chunk.frames.push_back(frame.clone());
+            frameIdx++;
+            if ((int)chunk.frames.size() == chunkSize) {
+                queue.push(std::move(chunk));
+                chunk = FrameChunk{++pushed, frameIdx, {}};
+            }
+        }
+        if (!chunk.frames.empty()) {
+            queue.push(std::move(chunk));
+            pushed++;
+        }
+        queue.close();
+
+        lock_guard<mutex> lock(resultsMtx);
+        totalChunks = pushed;
+        resultReady.notify_all();
+    });
+
+    // --- Detección en paralelo, fuera de orden ---
+    vector<thread> pool;
+    for (int w = 0; w < workers; w++) {
+        pool.emplace_back([&] {
+            FrameChunk chunk;
+            while (queue.pop(chunk)) {
+                ChunkResult r = processChunk(det, chunk);
+                lock_guard<mutex> lock(resultsMtx);
+                done.emplace(chunk.index, std::move(r));
+                resultReady.notify_all();
+            }
+        });
+    }
+
+    // --- Reensamblado en orden ---
+    auto t0 = chrono::steady_clock::now();
+    size_t nextChunk = 0, framesDone = 0, detections = 0;
+    bool headerWritten = false;
+    while (true) {
+        ChunkResult r;
+        {
+            unique_lock<mutex> lock(resultsMtx);
+            resultReady.wait(lock, [&] { return done.count(nextChunk) || nextChunk >= totalChunks; });
+            if (!done.count(nextChunk)) break;
+            r = std::move(done[nextChunk]);
+            done.erase(nextChunk);
+        }
+        if (!headerWritten) {
+            writer.writeHeader(frameW, frameH);
+            headerWritten = true;
+        }
+        for (const auto& d : r.detections) writer.write(d);
+        framesDone += r.frames;
+        detections += r.detections.size();
+        nextChunk++;
+
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        cout << " " << stem << " | Frames: " << framesDone << " | Detecciones: " << detections
+             << " | " << (int)(framesDone / max(secs, 1e-3)) << " fps\r" << flush;
+    }
+
+    decoder.join();
+    for (auto& t : pool) t.join();
+    if (!headerWritten) writer.writeHeader(frameW, frameH);
+
+    // En un directorio el índice de frame es la posición en esta lista. Se escribe al terminar
+    // para que solo incluya las imágenes decodificadas (las ilegibles no consumen índice)
+    if (source.isDirectory()) {
+        ofstream list((fs::path(outDir) / (stem + ".frames.txt")).string());
+        for (const auto& img : source.decodedImages()) list << fs::path(img).filename().string() << "\n";
+    }
+
+    cout << endl << "✅ " << input << " -> " << outPath << " (" << framesDone << " frames, "
+         << detections << " detecciones)" << endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    string modelPath = DEFAULT_MODEL;
+    string outDir = ".";
+    bool batch = false;
+    int workers = max(1, (int)thread::hardware_concurrency() - 1); // Un núcleo para decodificar
+    int chunkSize = DEFAULT_CHUNK;
+    vector<string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--batch") batch = true;
+        else if (arg == "--model" && i + 1 < argc) modelPath = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) outDir = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) workers = max(1, atoi(argv[++i]));
+        else if (arg == "--chunk" && i + 1 < argc) chunkSize = max(1, atoi(argv[++i]));
+        else if (arg == "--help") {
+            cout << "Uso: " << argv[0] << " [--batch] [--model detector.(txt|yml)] [--out dir] "
+                 << "[--threads N] [--chunk N] [video|directorio ...]" << endl;
+            return 0;
+        }
+        else inputs.push_back(arg);
+    }
+
+    PoseDetector det;
+    if (!loadPoseDetector(modelPath, det, batch)) return -1;
+
+    if (!batch) return runInteractive(det, inputs.empty() ? DEFAULT_VIDEO : inputs[0]);
+
+    if (inputs.empty()) {
+        cerr << "❌ Modo lote: indica al menos un video o directorio." << endl;
+        return -1;
+    }
+
+    // El paralelismo es por bloques de frames: evitar que OpenCV lance sus propios hilos encima
+    setNumThreads(1);
+    fs::create_directories(outDir);
+
+    cout << "🚀 Modo lote | Hilos de detección: " << workers << " | Frames por bloque: " << chunkSize << endl;
+    int status = 0;
+    vector<string> stems = uniqueStems(inputs);
+    for (size_t i = 0; i < inputs.size(); i++) {
+        if (runBatchOne(det, inputs[i], stems[i], outDir, workers, chunkSize) != 0) status = -1;
+    }
+    return status;
+}
@@ -0,0 +1,122 @@
+/**
+ * codigo/classes/quantize_svm.cpp
+ * Calibra el SVM lineal cuantizado (int8) a partir del detector float del entrenador
+ * y reporta la deriva de puntuación y el impacto en precisión frente al camino float.
+ *
+ * Uso: ./quantize_svm [detector.(txt|yml)] [dir_positivos] [dir_negativos] [salida.yml]
+ */
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <cmath>
+#include "../cabezeras/HOGKernel.h"
+
+namespace fs = std::filesystem;
+
+// --- CONFIGURACIÓN (valores por defecto) ---
+const std::string DEFAULT_DETECTOR = "hog_wrestling.yml";
+const std::string DEFAULT_POS_DIR = "dataset/pos/";
+const std::string DEFAULT_NEG_DIR = "dataset/neg/";
+
+struct Sample {
+    std::vector<float> descriptor;
+    int label;
+};
+
+void loadSamples(const std::string& dir, int label, cv::HOGDescriptor& hog, std::vector<Sample>& out) {
+    if (!fs::exists(dir)) {
+        std::cerr << "Advertencia: no existe " << dir << std::endl;
+        return;
+    }
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        cv::Mat img = cv::imread(entry.path().string(), cv::IMREAD_GRAYSCALE);
+        if (img.empty()) continue;
+        cv::resize(img, img, hog.winSize);
+
+        Sample s;
+        s.label = label;
+        hog.compute(img, s.descriptor);
+        out.push_back(s);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string detectorPath = argc > 1 ? argv[1] : DEFAULT_DETECTOR;
+    std::string posDir = argc > 2 ? argv[2] : DEFAULT_POS_DIR;
+    std::string negDir = argc > 3 ? argv[3] : DEFAULT_NEG_DIR;
+    // Por defecto junto al modelo, que es donde lo busca detect_poses_hog
+    std::string outPath = argc > 4 ? argv[4] : fs::path(detectorPath).replace_extension().string() + "_q8.yml";
+
+    std::vector<float> detector = loadHOGDetector(detectorPath);
+    cv::Size winSize = hogWinSizeFor(detector.size());
+    if (winSize.area() == 0) {
+        std::cerr << "❌ ERROR: detector de " << detector.size() << " valores no corresponde a ninguna geometría conocida." << std::endl;
+        return -1;
+    }
+
+    // Misma configuración HOG que el entrenador
+    cv::HOGDescriptor hog(winSize, cv::Size(16, 16), cv::Size(8, 8), cv::Size(8, 8), 9);
+
+    std::cout << "[INFO] Detector: " << detectorPath << " (" << winSize << ", "
+              << detector.size() - 1 << " pesos)" << std::endl;
+
+    // --------- CUANTIZAR ---------
+    QuantizedSVM q = quantizeSVM(detector);
+
+    double maxWeightErr = 0.0;
+    for (size_t i = 0; i < q.weights.size(); i++) {
+        maxWeightErr = std::max(maxWeightErr, std::abs(detector[i] - q.weights[i] * q.scale));
+    }
+    std::cout << "[INFO] Escala int8: " << q.scale << " | Error máx. por peso: " << maxWeightErr << std::endl;
+
+    // --------- CALIBRACIÓN ---------
+    std::vector<Sample> samples;
+    loadSamples(posDir, +1, hog, samples);
+    loadSamples(negDir, -1, hog, samples);
+
+    if (samples.empty()) {
+        std::cerr << "⚠️  Sin muestras de calibración: se guarda el modelo sin reporte de precisión." << std::endl;
+    } else {
+        double sumDrift = 0.0, maxDrift = 0.0, sumScore = 0.0, sumScore2 = 0.0;
+        int floatCorrect = 0, quantCorrect = 0, flips = 0;
+
+        for (const auto& s : samples) {
+            double fScore = detector.back();
+            for (size_t i = 0; i < s.descriptor.size(); i++) fScore += (double)s.descriptor[i] * detector[i];
+            double qScore = quantizedScore(q, s.descriptor);
+
+            double drift = std::abs(qScore - fScore);
+            sumDrift += drift;
+            maxDrift = std::max(maxDrift, drift);
+            sumScore += fScore;
+            sumScore2 += fScore * fScore;
+
+            if ((fScore > 0 ? 1 : -1) == s.label) floatCorrect++;
+            if ((qScore > 0 ? 1 : -1) == s.label) quantCorrect++;
+            if ((fScore > 0) != (qScore > 0)) flips++;
+        }
+
+        double n = (double)samples.size();
+        double stdScore = std::sqrt(std::max(0.0, sumScore2 / n - (sumScore / n) * (sumScore / n)));
+
+        std::cout << "-----------------------------------------------------" << std::endl;
+        std::cout << "Muestras de calibración: " << samples.size() << std::endl;
+        std::cout << "Deriva media: " << sumDrift / n << " | Deriva máx.: " << maxDrift
+                  << " | Desv. estándar de la puntuación float: " << stdScore << std::endl;
+        std::cout << "Precisión float: " << 100.0 * floatCorrect / n << " %" << std::endl;
+        std::cout << "Precisión int8:  " << 100.0 * quantCorrect / n << " %" << std::endl;
+        std::cout << "Decisiones que cambian de signo: " << flips << std::endl;
+        std::cout << "-----------------------------------------------------" << std::endl;
+    }
+
+    // --------- GUARDAR MODELO ---------
+    if (!saveQuantizedSVM(outPath, q, winSize)) {
+        std::cerr << "❌ ERROR: no se pudo escribir " << outPath << std::endl;
+        return -1;
+    }
+    std::cout << "✅ MODELO CUANTIZADO GUARDADO: " << outPath << std::endl;
+    return 0;
+}
@@ -4,7 +4,9 @@ import torch
 import io
 import uvicorn
 import base64
-from fastapi import FastAPI, UploadFile, File
+import json
+from typing import List
+from fastapi import FastAPI, UploadFile, File, Form
 from fastapi.responses import HTMLResponse, JSONResponse
 from ultralytics import YOLO
 from telegram import Bot
@@ -107,6 +109,15 @@ async def get_data():
         "last": stats["last_alert"]
     })
 
+def confident_keypoints(result):
+    # Number of keypoints above 0.5 confidence for the first person (0 if none)
+    if len(result.boxes) == 0 or result.keypoints is None or result.keypoints.conf is None:
+        return 0
+    return int(torch.sum(result.keypoints.conf[0] > 0.5).item())
+
+def is_valid_pose(result):
+    return confident_keypoints(result) > 7
+
 @app.post("/detect")
 async def detect_api(file: UploadFile = File(...)):
     global last_processed_base64
@@ -126,21 +137,63 @@ async def detect_api(file: UploadFile = File(...)):
     last_processed_base64 = base64.b64encode(buffer).decode('utf-8')
 
     # Logical check for person pose detection
-    if len(result.boxes) > 0 and result.keypoints is not None:
-        # Check if confidence of keypoints exists and meets criteria
-        confidences = result.keypoints.conf[0]
-        if torch.sum(confidences > 0.5).item() > 7:
-            stats["total_detections"] += 1
-            stats["last_alert"] = datetime.now().strftime("%H:%M:%S")
-
-            if config["send_telegram"]:
-                tg_img = annotated if config["visual_mode"] == "yolo" else img
-                _, buffer_tg = cv2.imencode(".jpg", tg_img)
-                # Note: Bot usage might require an initialized session in some environments
-                await bot.send_photo(chat_id=CHAT_ID, photo=buffer_tg.tobytes(), caption=f"🚨 Alerta #{stats['total_detections']}")
-                return {"status": "ok", "action": "sent"}
+    if is_valid_pose(result):
+        stats["total_detections"] += 1
+        stats["last_alert"] = datetime.now().strftime("%H:%M:%S")
+
+        if config["send_telegram"]:
+            tg_img = annotated if config["visual_mode"] == "yolo" else img
+            _, buffer_tg = cv2.imencode(".jpg", tg_img)
+            # Note: Bot usage might require an initialized session in some environments
+            await bot.send_photo(chat_id=CHAT_ID, photo=buffer_tg.tobytes(), caption=f"🚨 Alerta #{stats['total_detections']}")
+            return {"status": "ok", "action": "sent"}
             
     return {"status": "ok", "detected": False}
 
+@app.post("/detect_batch")
+async def detect_batch_api(files: List[UploadFile] = File(...), meta: str = Form("{}")):
+    """All crops of a frame (or time window) in one request; YOLO runs them as a single batch."""
+    global last_processed_base64
+    if not config["active"]:
+        return {"status": "paused", "results": []}
+
+    boxes = json.loads(meta).get("boxes", [])
+    imgs = []
+    for f in files:
+        nparr = np.frombuffer(await f.read(), np.uint8)
+        imgs.append(cv2.imdecode(nparr, cv2.IMREAD_COLOR))
+
+    valid = [i for i, img in enumerate(imgs) if img is not None]
+    predictions = model.predict([imgs[i] for i in valid], conf=0.6, device=device, verbose=False) if valid else []
+
+    def hog_conf(i):
+        return boxes[i].get("conf", 0.0) if i < len(boxes) else 0.0
+
+    results = [{"index": i, "detected": 0, "keypoints": 0} for i in range(len(imgs))]
+    alert = None
+    for i, result in zip(valid, predictions):
+        kp = confident_keypoints(result)
+        results[i]["keypoints"] = kp
+        if kp > 7:
+            results[i]["detected"] = 1
+            if alert is None or hog_conf(i) > hog_conf(alert[0]):
+                alert = (i, result)
+
+    if predictions:
+        _, buffer = cv2.imencode(".jpg", predictions[-1].plot() if alert is None else alert[1].plot())
+        last_processed_base64 = base64.b64encode(buffer).decode('utf-8')
+
+    # One alert per batch: the most confident confirmed crop
+    if alert is not None:
+        stats["total_detections"] += 1
+        stats["last_alert"] = datetime.now().strftime("%H:%M:%S")
+        if config["send_telegram"]:
+            i, result = alert
+            tg_img = result.plot() if config["visual_mode"] == "yolo" else imgs[i]
+            _, buffer_tg = cv2.imencode(".jpg", tg_img)
+            await bot.send_photo(chat_id=CHAT_ID, photo=buffer_tg.tobytes(), caption=f"🚨 Alerta #{stats['total_detections']}")
+
+    return {"status": "ok", "results": results}
+
 if __name__ == "__main__":
     uvicorn.run(app, host="0.0.0.0", port=8000)
\ No newline at end of file
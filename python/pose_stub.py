@@ -0,0 +1,108 @@
+"""
+Local stand-in for pose.py (no YOLO, no Telegram, standard library only).
+
+Answers /detect and /detect_batch with the same JSON shape as the real API so
+the C++ client can be exercised without a GPU or network:
+
+    python3 python/pose_stub.py --port 8000 --delay 0.05
+
+A crop counts as a pose when it is taller than it is wide (h/w >= 1.2).
+"""
+import argparse
+import json
+import time
+from email.parser import BytesParser
+from email.policy import HTTP
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+args = None
+stats = {"requests": 0, "crops": 0}
+
+
+def parse_multipart(headers, body):
+    # Returns [(field_name, filename, payload_bytes), ...]
+    raw = b"Content-Type: " + headers["Content-Type"].encode() + b"\r\n\r\n" + body
+    msg = BytesParser(policy=HTTP).parsebytes(raw)
+    parts = []
+    for part in msg.iter_parts():
+        parts.append((part.get_param("name", header="content-disposition"),
+                      part.get_filename(),
+                      part.get_payload(decode=True)))
+    return parts
+
+
+def jpeg_size(data):
+    # (width, height) from the first SOF marker, or None if it is not a JPEG
+    if data[:2] != b"\xff\xd8":
+        return None
+    i = 2
+    while i + 9 < len(data):
+        if data[i] != 0xFF:
+            return None
+        marker = data[i + 1]
+        length = int.from_bytes(data[i + 2:i + 4], "big")
+        if 0xC0 <= marker <= 0xCF and marker not in (0xC4, 0xC8, 0xCC):
+            return (int.from_bytes(data[i + 7:i + 9], "big"), int.from_bytes(data[i + 5:i + 7], "big"))
+        i += 2 + length
+    return None
+
+
+def evaluate(payload):
+    size = jpeg_size(payload)
+    if size is None:
+        return 0, 0
+    w, h = size
+    detected = 1 if h >= 1.2 * w else 0
+    return detected, 12 if detected else 3
+
+
+class Handler(BaseHTTPRequestHandler):
+    def do_POST(self):
+        body = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+        parts = parse_multipart(self.headers, body)
+        if args.delay > 0:
+            time.sleep(args.delay)
+
+        if self.path == "/detect":
+            files = [p for p in parts if p[0] == "file"]
+            detected, _ = evaluate(files[0][2]) if files else (0, 0)
+            reply = {"status": "ok", "detected": bool(detected)}
+        elif self.path == "/detect_batch":
+            files = [p for p in parts if p[0] == "files"]
+            meta = next((p[2] for p in parts if p[0] == "meta"), b"{}")
+            boxes = json.loads(meta).get("boxes", [])
+            results = []
+            for i, (_, _, payload) in enumerate(files):
+                detected, kp = evaluate(payload)
+                results.append({"index": i, "detected": detected, "keypoints": kp})
+            reply = {"status": "ok", "results": results}
+            print(f"batch: {len(files)} crops, {len(boxes)} boxes, "
+                  f"{sum(r['detected'] for r in results)} poses")
+        else:
+            self.send_error(404)
+            return
+
+        stats["requests"] += 1
+        stats["crops"] += len([p for p in parts if p[2] and p[1]])
+        data = json.dumps(reply).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def log_message(self, fmt, *a):
+        pass
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--delay", type=float, default=0.0, help="simulated inference time (s)")
+    args = parser.parse_args()
+    server = ThreadingHTTPServer(("0.0.0.0", args.port), Handler)
+    print(f"pose stub listening on :{args.port}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        print(f"requests: {stats['requests']}, crops: {stats['crops']}")